@@ -0,0 +1,132 @@
+// Advent of Code 2017 benchmark suite
+//
+// Links every day's solver into one program, like driver.cc, and runs each
+// day's benchmark suite: the day's core functions, timed on inputs from
+// deterministic generators at a range of scales, where a scale is a multiple of
+// the puzzle input's size (or, for days whose input is a single value, a
+// number of inputs).  The results are written to stdout as JSON, e.g.:
+//
+//   {"scales": [1, 1000], "results": [
+//     {"day": 1, "name": "SumMatchingDigits()", "scale": 1, "items": 2000,
+//      "unit": "digits", "runs": 20, "median_ms": 0.0021, "p99_ms": 0.0035,
+//      "items_per_second": 952380952, "allocations_per_run": 0.0},
+//     ...
+//   ]}
+//
+// Each result also goes to stderr as soon as it's measured, to show progress.
+// Scales too large for a day to generate in reasonable time and memory are
+// reported with "skipped": true.  Each case is run once to warm up, then
+// repeatedly until it has run --runs times or for two seconds, but at least
+// three times.  Allocations are counted by replacing the global operator new.
+// Comparing two versions' reports catches regressions.
+//
+// Options:
+//   --scales=N,...  The scales to run (default: 1,1000).
+//   --runs=N        The most times to run each case (default: 20).
+//   --days=N,...    Only run these days (default: all).
+//
+// Build with all the days, e.g.:
+//
+//   g++ -std=c++17 -O2 -pthread -DADVENT_DRIVER bench.cc day*.cc -o bench
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.h"
+#include "solver.h"
+
+// Count every allocation, so the suite can report allocations per run.  The
+// other forms of operator new all call this one.
+void* operator new(std::size_t size) {
+  benchmark::allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* const p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+// The suites, indexed by day - 1.
+constexpr solver::SuiteFunction kSuites[] = {
+  day1::RunSuite,  day2::RunSuite,  day3::RunSuite,  day4::RunSuite,
+  day5::RunSuite,  day6::RunSuite,  day7::RunSuite,  day8::RunSuite,
+  day9::RunSuite,  day10::RunSuite, day11::RunSuite, day12::RunSuite,
+  day13::RunSuite, day14::RunSuite, day15::RunSuite, day16::RunSuite,
+  day17::RunSuite,
+};
+constexpr std::size_t kDays = std::size(kSuites);
+
+// Parses |list|, a comma-separated list of positive numbers, into |*numbers|.
+// Returns false if any element isn't a positive number.
+bool ParseList(std::string_view list, std::vector<std::size_t>* numbers) {
+  numbers->clear();
+  while (!list.empty()) {
+    const std::size_t comma = list.find(',');
+    const std::string element(list.substr(0, comma));
+    char* end;
+    const unsigned long long number = std::strtoull(element.c_str(), &end, 10);
+    if (element.empty() || *end || !number)
+      return false;
+    numbers->push_back(number);
+    list.remove_prefix((comma == std::string_view::npos) ? list.size()
+                                                          : (comma + 1));
+  }
+  return !numbers->empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::size_t> scales = {1, 1000}, days;
+  int runs = 20;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    constexpr std::string_view kScalesFlag = "--scales=";
+    constexpr std::string_view kRunsFlag = "--runs=";
+    constexpr std::string_view kDaysFlag = "--days=";
+    bool valid = true;
+    if (arg.substr(0, kScalesFlag.size()) == kScalesFlag) {
+      valid = ParseList(arg.substr(kScalesFlag.size()), &scales);
+    } else if (arg.substr(0, kRunsFlag.size()) == kRunsFlag) {
+      runs = std::atoi(argv[i] + kRunsFlag.size());
+      valid = runs > 0;
+    } else if (arg.substr(0, kDaysFlag.size()) == kDaysFlag) {
+      valid = ParseList(arg.substr(kDaysFlag.size()), &days);
+      for (std::size_t day : days)
+        valid &= day <= kDays;
+    } else {
+      valid = false;
+    }
+    if (!valid) {
+      std::cerr << "Usage: " << argv[0]
+                << " [--scales=N,...] [--runs=N] [--days=N,...]" << std::endl;
+      return 1;
+    }
+  }
+  if (days.empty()) {
+    for (std::size_t day = 1; day <= kDays; ++day)
+      days.push_back(day);
+  }
+
+  benchmark::Suite suite(scales, runs);
+  for (std::size_t day : days) {
+    suite.set_day(static_cast<int>(day));
+    kSuites[day - 1](&suite);
+  }
+  std::cout << suite.ToJson();
+  return 0;
+}
@@ -0,0 +1,211 @@
+// Advent of Code 2017 benchmarking helpers
+//
+// Each day's solution can be run with "--benchmark" on the command line to time
+// its core functions on generated inputs instead of reading puzzle input.
+//
+// bench.cc also runs every day's benchmark suite: each day's RunSuite() times
+// its core functions through a Suite on generated inputs scaled to multiples of
+// the puzzle's size, and the Suite reports the results as JSON.
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace benchmark {
+
+// Returns whether "--benchmark" appears among the command-line arguments.
+inline bool Requested(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--benchmark"))
+      return true;
+  }
+  return false;
+}
+
+// Runs |func| once to warm up, then |runs| more times, and returns the median
+// wall time of a single run in seconds.  |func| should read its inputs from and
+// store its results to volatile variables, so that the compiler can neither
+// precompute the work nor move it out of the timed runs.
+template<typename Func>
+double MedianSeconds(Func func, int runs = 5) {
+  func();
+  std::vector<double> times;
+  for (int i = 0; i < runs; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    times.push_back(elapsed.count());
+  }
+  std::nth_element(times.begin(), times.begin() + times.size() / 2,
+                   times.end());
+  return times[times.size() / 2];
+}
+
+// The number of heap allocations made so far.  Only programs that replace the
+// global operator new to increment this, as bench.cc does, count anything.
+inline std::atomic<std::uint64_t> allocations(0);
+
+// Keeps the compiler from discarding |value| as unused, so that the work to
+// compute it can't be optimized away.
+template<typename T>
+inline void KeepResult(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static const void* volatile sink;
+  sink = &value;
+#endif
+}
+
+// Returns |value| after hiding it from the compiler, which must then assume it
+// could be anything.  Passing a timed function's scalar inputs through this
+// keeps a pure call from being computed once and moved out of the timed loop.
+template<typename T>
+inline T HideInput(T value) {
+  static_assert(std::is_scalar_v<T>, "only scalars fit in a register");
+#if defined(__GNUC__)
+  asm volatile("" : "+r"(value));
+  return value;
+#else
+  const volatile T hidden = value;
+  return hidden;
+#endif
+}
+
+// Times functions at a set of input scales and collects the results as JSON.
+// The days' input generators all use a fixed seed, so that every run times the
+// same inputs and reports from different runs and versions are comparable.
+class Suite {
+ public:
+  // Each case is run once to warm up, then up to |max_runs| times, stopping
+  // early (after at least three runs) once the runs have taken |budget_seconds|
+  // in total.
+  Suite(std::vector<std::size_t> scales,
+        int max_runs,
+        double budget_seconds = 2);
+
+  // Sets the day that subsequent results are recorded for.
+  void set_day(int day) { day_ = day; }
+
+  // Returns the suite's scales that are at most |max_scale|, the largest that
+  // the current day can generate in reasonable time and memory.  Larger scales
+  // are recorded as skipped, so the report still covers every scale.
+  std::vector<std::size_t> Scales(std::size_t max_scale);
+
+  // Times |func|, which should return its result so that it can't be optimized
+  // away, on an input at |scale| holding |items| units of work of kind |unit|
+  // (e.g. "digits").  |func| should pass any scalar inputs it captures through
+  // HideInput(), so that each run really computes its result.
+  template<typename Func>
+  void Run(const std::string& name,
+           std::size_t scale,
+           double items,
+           const char* unit,
+           Func func);
+
+  // Returns the results recorded so far as a JSON object, with one result per
+  // line.
+  std::string ToJson() const;
+
+ private:
+  const std::vector<std::size_t> scales_;
+  const int max_runs_;
+  const double budget_seconds_;
+  int day_ = 0;
+  std::vector<std::string> results_;  // Each a JSON object.
+};
+
+inline Suite::Suite(std::vector<std::size_t> scales,
+                    int max_runs,
+                    double budget_seconds)
+    : scales_(std::move(scales)),
+      max_runs_(std::max(max_runs, 1)),
+      budget_seconds_(budget_seconds) {}
+
+inline std::vector<std::size_t> Suite::Scales(std::size_t max_scale) {
+  std::vector<std::size_t> scales;
+  for (std::size_t scale : scales_) {
+    if (scale <= max_scale) {
+      scales.push_back(scale);
+    } else {
+      results_.push_back("{\"day\": " + std::to_string(day_) +
+                         ", \"scale\": " + std::to_string(scale) +
+                         ", \"skipped\": true}");
+    }
+  }
+  return scales;
+}
+
+template<typename Func>
+void Suite::Run(const std::string& name,
+                std::size_t scale,
+                double items,
+                const char* unit,
+                Func func) {
+  KeepResult(func());
+
+  std::vector<double> times;
+  times.reserve(max_runs_);  // So that recording times doesn't allocate.
+  double total_seconds = 0;
+  const std::uint64_t start_allocations = allocations.load();
+  while ((times.size() < static_cast<std::size_t>(max_runs_)) &&
+         ((times.size() < 3) || (total_seconds < budget_seconds_))) {
+    const auto start = std::chrono::steady_clock::now();
+    KeepResult(func());
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    times.push_back(elapsed.count());
+    total_seconds += elapsed.count();
+  }
+  const double runs = static_cast<double>(times.size());
+  const double allocations_per_run =
+      (allocations.load() - start_allocations) / runs;
+
+  // The p99 is the nearest-rank percentile, so with fewer than 100 runs it's
+  // the slowest run.
+  std::sort(times.begin(), times.end());
+  const double median = times[times.size() / 2];
+  const double p99 =
+      times[static_cast<std::size_t>(std::ceil(runs * 0.99)) - 1];
+
+  char numbers[256];
+  std::snprintf(numbers, sizeof(numbers),
+                "\"runs\": %zu, \"median_ms\": %.4f, \"p99_ms\": %.4f, "
+                "\"items_per_second\": %.0f, \"allocations_per_run\": %.1f",
+                times.size(), median * 1000, p99 * 1000, items / median,
+                allocations_per_run);
+  results_.push_back("{\"day\": " + std::to_string(day_) + ", \"name\": \"" +
+                     name + "\", \"scale\": " + std::to_string(scale) +
+                     ", \"items\": " + std::to_string(std::llround(items)) +
+                     ", \"unit\": \"" + unit + "\", " + numbers + "}");
+  std::cerr << results_.back() << std::endl;
+}
+
+inline std::string Suite::ToJson() const {
+  std::string json = "{\"scales\": [";
+  for (std::size_t i = 0; i < scales_.size(); ++i)
+    json += (i ? ", " : "") + std::to_string(scales_[i]);
+  json += "], \"results\": [";
+  for (std::size_t i = 0; i < results_.size(); ++i)
+    json += (i ? ",\n  " : "\n  ") + results_[i];
+  json += "\n]}\n";
+  return json;
+}
+
+}  // namespace benchmark
+
+#endif  // BENCHMARK_H_
@@ -4,12 +4,18 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <random>
+#include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // Tokenizes |input|, a string of digits, to a vector of individual digits.
 std::vector<int> Tokenize(const std::string& input) {
@@ -23,33 +29,92 @@ std::vector<int> Tokenize(const std::string& input) {
   return digits;
 }
 
-// Returns the sum of the digits in |digits| that match a particular later
-// digit.  In part 1, this is the next digit; in part 2, the digit halfway
-// around |digits|.
-int SumMatchingDigits(const std::vector<int>& digits) {
-  // Compute the increment to the digit we're interested in.
-  const std::size_t size = digits.size();
-  const std::size_t increment = kPart1 ? 1 : (size / 2);
-
-  // Sum digits that match the one |increment| places away, treating |digits|
+// Returns the sums of the digits in |digits| that match a particular later
+// digit.  For part 1, this is the next digit; for part 2, the digit halfway
+// around |digits|.  Both sums are computed in the same pass.
+std::tuple<int, int> SumMatchingDigits(const std::vector<int>& digits) {
+  // Sum digits that match the one 1 and |half| places away, treating |digits|
   // circularly.
-  int sum = 0;
+  const std::size_t size = digits.size();
+  const std::size_t half = size / 2;
+  int next_sum = 0, halfway_sum = 0;
   for (std::size_t i = 0; i < size; ++i) {
     const int digit = digits[i];
-    if (digit == digits[(i + increment) % size])
-      sum += digit;
+    if (digit == digits[(i + 1) % size])
+      next_sum += digit;
+    if (digit == digits[(i + half) % size])
+      halfway_sum += digit;
   }
-  return sum;
+  return {next_sum, halfway_sum};
 }
 
 }  // namespace
 
+namespace day1 {
+
+solver::Answers Solve(const std::string& input, options::Part) {
+  std::vector<int> digits;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    // The CAPTCHA is the first word of the input.
+    std::istringstream stream(input);
+    std::string captcha;
+    stream >> captcha;
+    digits = Tokenize(captcha);
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  const auto sums = SumMatchingDigits(digits);
+  return {std::to_string(std::get<0>(sums)), std::to_string(std::get<1>(sums))};
+}
+
+// Returns a CAPTCHA of |digits| random digits.
+std::string GenerateCaptcha(std::size_t digits) {
+  std::mt19937 generator(2017);
+  std::string captcha(digits, '0');
+  for (char& c : captcha)
+    c = static_cast<char>('0' + generator() % 10);
+  return captcha;
+}
+
+// Times SumMatchingDigits() on CAPTCHAs of 2,000 digits, about the puzzle's
+// length, times each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleDigits = 2000;
+  for (std::size_t scale : suite->Scales(10000)) {
+    const std::vector<int> digits =
+        Tokenize(GenerateCaptcha(kPuzzleDigits * scale));
+    suite->Run("SumMatchingDigits()", scale, digits.size(), "digits",
+               [&digits]() { return SumMatchingDigits(digits); });
+  }
+}
+
+}  // namespace day1
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter CAPTCHA: ";
   std::string input;
-  std::cin >> input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::cin >> input;
+  }
 
-  std::cout << "Required sum is: " << SumMatchingDigits(Tokenize(input))
-            << std::endl;
+  const solver::Answers answers = day1::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Required sum is: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Required sum is: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(1);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
@@ -2,27 +2,44 @@
 // Peter Kasting, Dec. 10, 2017
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
+
 namespace {
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+// Hardcoded suffix appended to the lengths in part 2.
+constexpr std::size_t kSuffix[5] = {17, 31, 73, 47, 23};
 
 // Converts |input| to a series of lengths to use to permute the circular list.
 // In part 1, the input is parsed as comma-delimited lengths.  In part 2, each
 // character of the input string is treated as a byte, whose ASCII value is a
 // length.
-std::vector<std::size_t> Tokenize(const std::string& input) {
+std::vector<std::size_t> Tokenize(const std::string& input, bool part1) {
   std::vector<std::size_t> lengths;
-  if (kPart1) {
+  if (part1) {
     // Split into comma-delimited lengths.
     std::istringstream stringstream(input);
     for (std::string length; std::getline(stringstream, length, ','); )
@@ -33,14 +50,14 @@ std::vector<std::size_t> Tokenize(const std::string& input) {
       lengths.push_back(c);
 
     // Add hardcoded suffix.
-    constexpr std::size_t kSuffix[5] = {17, 31, 73, 47, 23};
     lengths.insert(lengths.end(), std::begin(kSuffix), std::end(kSuffix));
   }
   return lengths;
 }
 
 // Computes a "sparse hash" using |lengths|.
-std::vector<std::uint8_t> SparseHash(const std::vector<std::size_t>& lengths) {
+std::vector<std::uint8_t> SparseHash(const std::vector<std::size_t>& lengths,
+                                     bool part1) {
   // Initial vector is the series {0, 1, 2, ..., 255}.
   constexpr std::size_t kListLength = 256;
   std::vector<std::uint8_t> hash(kListLength);
@@ -56,7 +73,7 @@ std::vector<std::uint8_t> SparseHash(const std::vector<std::size_t>& lengths) {
 
   // Permute for 1 or 64 rounds (depending on the part), preserving the position
   // and skip length between rounds.
-  const int kRounds = kPart1 ? 1 : 64;
+  const int kRounds = part1 ? 1 : 64;
   std::size_t position = 0, skip_length = 0;
   for (int i = 0; i < kRounds; ++i) {
     for (std::size_t length : lengths) {
@@ -69,49 +86,419 @@ std::vector<std::uint8_t> SparseHash(const std::vector<std::size_t>& lengths) {
   return hash;
 }
 
+// The number of bytes in a dense knot hash.
+constexpr std::size_t kDigestSize = 16;
+
+// A dense knot hash.
+using DenseHash = std::array<std::uint8_t, kDigestSize>;
+
+// Folds the 256-byte |sparse_hash| into a dense hash by XORing each group of 16
+// bytes, writing the kDigestSize results to |digest|.
+void FoldSparseHash(const std::uint8_t* sparse_hash, std::uint8_t* digest) {
+#if defined(__SSE2__)
+  // Each group is one 16-byte register.  Rather than reducing each register
+  // horizontally on its own, halve all of them together: every step XORs the
+  // two halves of each group's remaining bytes, and packs twice as many groups
+  // into each register for the next step.
+  __m128i groups[16];
+  for (std::size_t i = 0; i < 16; ++i) {
+    groups[i] = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(sparse_hash + i * 16));
+  }
+
+  // 16 bytes -> 8 bytes per group, two groups per register.
+  __m128i halves[8];
+  for (std::size_t i = 0; i < 8; ++i) {
+    halves[i] =
+        _mm_xor_si128(_mm_unpacklo_epi64(groups[2 * i], groups[2 * i + 1]),
+                      _mm_unpackhi_epi64(groups[2 * i], groups[2 * i + 1]));
+  }
+
+  // 8 bytes -> 4 bytes per group, four groups per register.  The shuffles pick
+  // the even and odd dwords of a register pair, which are the two 4-byte halves
+  // of each group.
+  __m128i quarters[4];
+  for (std::size_t i = 0; i < 4; ++i) {
+    const __m128 a = _mm_castsi128_ps(halves[2 * i]);
+    const __m128 b = _mm_castsi128_ps(halves[2 * i + 1]);
+    quarters[i] = _mm_xor_si128(
+        _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))),
+        _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+  }
+
+  // 4 bytes -> 1 byte per group within each dword, then pack the low byte of
+  // each of the 16 dwords into a single register.  All values fit in a byte, so
+  // the saturating packs never saturate.
+  const __m128i low_byte = _mm_set1_epi32(0xff);
+  for (__m128i& quarter : quarters) {
+    quarter = _mm_xor_si128(quarter, _mm_srli_epi32(quarter, 16));
+    quarter = _mm_xor_si128(quarter, _mm_srli_epi32(quarter, 8));
+    quarter = _mm_and_si128(quarter, low_byte);
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(digest),
+                   _mm_packus_epi16(_mm_packs_epi32(quarters[0], quarters[1]),
+                                    _mm_packs_epi32(quarters[2], quarters[3])));
+#else
+  // Fold eight bytes at a time: XOR each group's two words together, then
+  // halve the word until a single byte is left.
+  for (std::size_t i = 0; i < kDigestSize; ++i, sparse_hash += 16) {
+    std::uint64_t words[2];
+    std::memcpy(words, sparse_hash, sizeof(words));
+    std::uint64_t val = words[0] ^ words[1];
+    val ^= val >> 32;
+    val ^= val >> 16;
+    val ^= val >> 8;
+    digest[i] = static_cast<std::uint8_t>(val);
+  }
+#endif
+}
+
 // Computes the "knot hash" of the provided |sparse_hash| by bitwise-XORing
-// groups of 16 numbers, then concatenating the bit representations of the
-// results.
-std::string KnotHash(const std::vector<std::uint8_t>& sparse_hash) {
-  // We could also manually convert to hex pretty easily (each nybble is just
-  // "0123456789abcdef"[nybble]), but the code reads a little more clearly
-  // using stringstreams and is at least as short.
+// groups of 16 numbers.
+DenseHash KnotHash(const std::vector<std::uint8_t>& sparse_hash) {
+  DenseHash hash;
+  FoldSparseHash(sparse_hash.data(), hash.data());
+  return hash;
+}
+
+// The number of characters in the hex representation of a dense hash.
+constexpr std::size_t kHexDigestSize = 2 * kDigestSize;
+
+// Returns a table of the two hex characters for each byte value, so converting
+// a byte is a single two-character copy.
+constexpr std::array<char, 512> MakeHexPairs() {
+  constexpr char kHexDigits[] = "0123456789abcdef";
+  std::array<char, 512> pairs = {};
+  for (std::size_t i = 0; i < 256; ++i) {
+    pairs[2 * i] = kHexDigits[i >> 4];
+    pairs[2 * i + 1] = kHexDigits[i & 0xf];
+  }
+  return pairs;
+}
+
+// Writes the lowercase hex representation of |hash| to the kHexDigestSize
+// characters at |output|.  No terminator is written.
+void ToHex(const DenseHash& hash, char* output) {
+#if defined(__SSSE3__)
+  // Split each byte into its nybbles, look all 16 of each up in the digit table
+  // at once, then interleave the high and low digits.
+  const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+  const __m128i nybble = _mm_set1_epi8(0xf);
+  const __m128i bytes =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(hash.data()));
+  const __m128i high = _mm_shuffle_epi8(
+      digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nybble));
+  const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nybble));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                   _mm_unpacklo_epi8(high, low));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 16),
+                   _mm_unpackhi_epi8(high, low));
+#else
+  static constexpr std::array<char, 512> kHexPairs = MakeHexPairs();
+  for (std::uint8_t val : hash) {
+    *output++ = kHexPairs[2 * val];
+    *output++ = kHexPairs[2 * val + 1];
+  }
+#endif
+}
+
+// The number of inputs HashLanes() permutes in lockstep on a single thread.
+// Each input reverses spans of its own list, and the spans depend on that
+// input's bytes, so there's nothing to share between lanes within a SIMD
+// register.  But interleaving the lanes' reversals gives the CPU independent
+// loads and stores to overlap instead of one serial chain of swaps.
+constexpr std::size_t kLanes = 4;
+
+// Computes the (part 2) knot hashes of the |count| (at most kLanes) inputs
+// inputs[indices[0]], inputs[indices[1]], ... in lockstep, writing the digest
+// of inputs[n] to |digests| + n * kDigestSize.  All the inputs must have the
+// same length, so that their length sequences (and thus skip lengths) stay in
+// step.
+void HashLanes(const std::vector<std::string>& inputs,
+               const std::size_t* indices,
+               std::size_t count,
+               std::uint8_t* digests) {
+  // The list length is 256, so using uint8_t for everything that indexes the
+  // list makes the circular wraparound free.
+  std::uint8_t lists[kLanes][256];
+  std::uint8_t positions[kLanes] = {};
+  for (std::size_t lane = 0; lane < count; ++lane)
+    std::iota(std::begin(lists[lane]), std::end(lists[lane]), 0);
+
+  const std::size_t input_length = inputs[indices[0]].size();
+  const std::size_t num_lengths = input_length + std::size(kSuffix);
+  std::uint8_t skip_length = 0;
+  constexpr int kRounds = 64;
+  for (int round = 0; round < kRounds; ++round) {
+    for (std::size_t n = 0; n < num_lengths; ++n, ++skip_length) {
+      for (std::size_t lane = 0; lane < count; ++lane) {
+        const std::uint8_t length = static_cast<std::uint8_t>(
+            (n < input_length) ? inputs[indices[lane]][n]
+                               : kSuffix[n - input_length]);
+        std::uint8_t* const list = lists[lane];
+        std::uint8_t i = positions[lane];
+        std::uint8_t j = i + length - 1;
+        for (std::uint8_t swaps = length / 2; swaps; --swaps, ++i, --j)
+          std::swap(list[i], list[j]);
+        positions[lane] += length + skip_length;
+      }
+    }
+  }
+
+  for (std::size_t lane = 0; lane < count; ++lane)
+    FoldSparseHash(lists[lane], digests + indices[lane] * kDigestSize);
+}
+
+// Computes the (part 2) knot hash of every string in |inputs|, writing the
+// digest of inputs[n] to |digests| + n * kDigestSize; |digests| must have room
+// for inputs.size() digests.  The work is spread across |threads| threads, or
+// one per hardware thread if |threads| is 0.
+void BatchKnotHash(const std::vector<std::string>& inputs,
+                   std::uint8_t* digests,
+                   unsigned threads = 0) {
+  // Order the inputs by length so equal-length inputs are adjacent, then cut
+  // that order into lane groups of up to kLanes equal-length inputs each.
+  // Group g covers order[group_starts[g]] to order[group_starts[g + 1] - 1].
+  std::vector<std::size_t> order(inputs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&inputs](std::size_t a, std::size_t b) {
+                     return inputs[a].size() < inputs[b].size();
+                   });
+  std::vector<std::size_t> group_starts;
+  for (std::size_t i = 0; i < order.size(); ) {
+    group_starts.push_back(i);
+    const std::size_t length = inputs[order[i]].size();
+    const std::size_t end = std::min(i + kLanes, order.size());
+    for (++i; (i < end) && (inputs[order[i]].size() == length); ++i) {}
+  }
+  group_starts.push_back(order.size());
+  const std::size_t groups = group_starts.size() - 1;
+
+  // Threads claim runs of groups from a shared counter rather than taking a
+  // fixed slice each, so no thread sits idle while another has work left.
+  constexpr std::size_t kGroupsPerClaim = 16;
+  std::atomic<std::size_t> next_group(0);
+  const auto Work = [&]() {
+    for (std::size_t first;
+         (first = next_group.fetch_add(kGroupsPerClaim)) < groups; ) {
+      const std::size_t last = std::min(first + kGroupsPerClaim, groups);
+      for (std::size_t g = first; g < last; ++g) {
+        HashLanes(inputs, &order[group_starts[g]],
+                  group_starts[g + 1] - group_starts[g], digests);
+      }
+    }
+  };
+
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  const std::size_t claims = (groups + kGroupsPerClaim - 1) / kGroupsPerClaim;
+  threads = static_cast<unsigned>(std::min<std::size_t>(threads, claims));
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; ++i)
+    workers.emplace_back(Work);
+  Work();  // The calling thread is one of the workers.
+  for (auto& worker : workers)
+    worker.join();
+}
+
+}  // namespace
+
+namespace day10 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  // The parts read the same line differently, so all they share is the read.
+  const std::string line = input.substr(0, input.find('\n'));
+  solver::Answers answers;
+  if (options::WantsPart1(part)) {
+    std::vector<std::size_t> lengths;
+    {
+      instrumentation::Phase phase(instrumentation::kParse);
+      lengths = Tokenize(line, true);
+    }
+    instrumentation::Phase phase(instrumentation::kSolve);
+    const std::vector<std::uint8_t> sparse_hash = SparseHash(lengths, true);
+    answers.part1 = std::to_string(sparse_hash[0] * sparse_hash[1]);
+  }
+  if (options::WantsPart2(part)) {
+    std::vector<std::size_t> lengths;
+    {
+      instrumentation::Phase phase(instrumentation::kParse);
+      lengths = Tokenize(line, false);
+    }
+    DenseHash hash;
+    {
+      instrumentation::Phase phase(instrumentation::kSolve);
+      hash = KnotHash(SparseHash(lengths, false));
+    }
+    // Formatting the digest as hex is part of the answer here.
+    instrumentation::Phase phase(instrumentation::kFormat);
+    char hex[kHexDigestSize];
+    ToHex(hash, hex);
+    answers.part2.assign(hex, kHexDigestSize);
+  }
+  return answers;
+}
+
+// Returns the hex digest of |sparse_hash| computed the straightforward way,
+// with std::accumulate() and an ostringstream, for comparison with
+// KnotHash() + ToHex().
+std::string StreamKnotHash(const std::vector<std::uint8_t>& sparse_hash) {
   std::ostringstream output;
   output << std::hex << std::setfill('0');
-  for (auto i = sparse_hash.cbegin(); i != sparse_hash.cend(); ) {
-    // XOR the next (up to) 16 numbers together.
-    constexpr std::size_t kValuesToXor = 16;
-    const size_t remaining_size =
-        static_cast<std::size_t>(std::distance(i, sparse_hash.end()));
-    const auto end = std::next(i, std::min(kValuesToXor, remaining_size));
-    // We use a uint32_t instead of a uint8_t because operator<<() below will
-    // ignore std::hex for uint8_t and treat it as a char instead, so the output
-    // will look like garbage.
+  for (auto i = sparse_hash.cbegin(); i != sparse_hash.cend(); i += 16) {
     const std::uint32_t val =
-        std::accumulate(i, end, 0, std::bit_xor<std::uint8_t>());
-
-    // setw() resets after "<< val", and so must be done here instead of above.
+        std::accumulate(i, i + 16, 0, std::bit_xor<std::uint8_t>());
     output << std::setw(2) << val;
-
-    i = end;
   }
   return output.str();
 }
 
+// Times folding and hex-formatting a million sparse hashes, both with
+// StreamKnotHash() and with KnotHash() + ToHex().
+void BenchmarkFormatting() {
+  constexpr std::size_t kHashes = 1000000;
+  std::vector<std::uint8_t> sparse_hash =
+      SparseHash(Tokenize("flqrgnkx", false), false);
+  std::size_t checksum = 0;  // Keeps the results observably used.
 
-}  // namespace
+  const double stream_seconds = benchmark::MedianSeconds(
+      [&sparse_hash, &checksum]() {
+        for (std::size_t i = 0; i < kHashes; ++i) {
+          sparse_hash[i & 0xff] ^= 1;
+          checksum += StreamKnotHash(sparse_hash)[i & 0x1f];
+        }
+      });
+  const double table_seconds = benchmark::MedianSeconds(
+      [&sparse_hash, &checksum]() {
+        char hex[kHexDigestSize];
+        for (std::size_t i = 0; i < kHashes; ++i) {
+          sparse_hash[i & 0xff] ^= 1;
+          ToHex(KnotHash(sparse_hash), hex);
+          checksum += hex[i & 0x1f];
+        }
+      });
+
+  char hex[kHexDigestSize];
+  ToHex(KnotHash(sparse_hash), hex);
+  const bool matches =
+      StreamKnotHash(sparse_hash) == std::string(hex, kHexDigestSize);
+  std::cout << "Fold + format, " << kHashes << " hashes: ostringstream "
+            << stream_seconds * 1000 << " ms, KnotHash() + ToHex() "
+            << table_seconds * 1000 << " ms (checksum " << checksum << ")"
+            << (matches ? "" : " (MISMATCH)") << std::endl;
+}
+
+// Times BatchKnotHash() on batches of 1, 128 and 1,000,000 generated keys, and
+// checks its digests against the single-input path.
+void BenchmarkBatches() {
+  for (std::size_t count : {1, 128, 1000000}) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+      keys.push_back("flqrgnkx-" + std::to_string(i));
+    std::vector<std::uint8_t> digests(count * kDigestSize);
+
+    // A million hashes takes long enough that one timed run is plenty.
+    const int runs = (count > 1000) ? 1 : 5;
+    const double seconds = benchmark::MedianSeconds(
+        [&keys, &digests]() { BatchKnotHash(keys, digests.data()); }, runs);
+
+    bool matches = true;
+    for (std::size_t i = 0; i < std::min<std::size_t>(count, 128); ++i) {
+      const DenseHash hash =
+          KnotHash(SparseHash(Tokenize(keys[i], false), false));
+      matches &=
+          std::equal(hash.begin(), hash.end(), &digests[i * kDigestSize]);
+    }
 
+    std::cout << "BatchKnotHash, " << count << " inputs: " << seconds * 1000
+              << " ms, " << count / seconds << " hashes/s"
+              << (matches ? "" : " (MISMATCH)") << std::endl;
+  }
+}
+
+void RunBenchmarks() {
+  BenchmarkFormatting();
+  BenchmarkBatches();
+}
+
+// Returns |count| random puzzle inputs, each 16 comma-separated lengths from 0
+// to 255.
+std::vector<std::string> GenerateKeys(std::size_t count) {
+  std::mt19937 generator(2017);
+  std::vector<std::string> keys(count);
+  for (std::string& key : keys) {
+    for (int i = 0; i < 16; ++i)
+      key += (i ? "," : "") + std::to_string(generator() % 256);
+  }
+  return keys;
+}
+
+// Times each part's hashing, one key at a time, and BatchKnotHash().  The
+// puzzle input is a single key, so each scale is a number of keys.
+void RunSuite(benchmark::Suite* suite) {
+  for (std::size_t scale : suite->Scales(100000)) {
+    const std::vector<std::string> keys = GenerateKeys(scale);
+    suite->Run("SparseHash(), part 1", scale, keys.size(), "keys", [&keys]() {
+      std::size_t sum = 0;
+      for (const std::string& key : keys) {
+        const std::vector<std::uint8_t> sparse_hash =
+            SparseHash(Tokenize(key, true), true);
+        sum += sparse_hash[0] * sparse_hash[1];
+      }
+      return sum;
+    });
+    suite->Run("KnotHash() + ToHex()", scale, keys.size(), "keys", [&keys]() {
+      std::size_t sum = 0;
+      char hex[kHexDigestSize];
+      for (const std::string& key : keys) {
+        ToHex(KnotHash(SparseHash(Tokenize(key, false), false)), hex);
+        sum += hex[0];
+      }
+      return sum;
+    });
+    std::vector<std::uint8_t> digests(keys.size() * kDigestSize);
+    suite->Run("BatchKnotHash()", scale, keys.size(), "keys",
+               [&keys, &digests]() {
+      BatchKnotHash(keys, digests.data());
+      return digests[0];
+    });
+  }
+}
+
+}  // namespace day10
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day10::RunBenchmarks();
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter length string: ";
   std::string input;
-  std::getline(std::cin, input);
-
-  std::vector<std::uint8_t> sparse_hash(SparseHash(Tokenize(input)));
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::getline(std::cin, input);
+  }
 
-  if (kPart1)
-    std::cout << "Product: " << sparse_hash[0] * sparse_hash[1] << std::endl;
-  else
-    std::cout << "Knot hash: " << KnotHash(sparse_hash) << std::endl;
+  const solver::Answers answers = day10::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Product: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Knot hash: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(10);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
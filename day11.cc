@@ -2,14 +2,28 @@
 // Peter Kasting, Dec. 10, 2017
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
 
-namespace {
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // A coordinate in a hex grid.  Columns of hexes are 1 horizontal unit apart
 // while within a column, each hex center is two vertical units apart.  This
@@ -22,7 +36,7 @@ public:
 
   // Moves the coordinate one hex in |direction|, which is one of
   // {"nw", "n", "ne", "se", "s", "sw"}.
-  void Move(const std::string& direction) {
+  void Move(std::string_view direction) {
     // Either we're travelling vertically within the current column, or
     // diagonally to a hex in an adjacent column.
     const bool diagonal = direction.length() > 1;
@@ -32,15 +46,29 @@ public:
     y += (direction[0] == 'n') ? delta_y : -delta_y;
   }
 
+  // Moves the coordinate by (|delta_x|, |delta_y|) units.
+  void Move(int delta_x, int delta_y) {
+    x += delta_x;
+    y += delta_y;
+  }
+
+  // Moves the coordinate by |delta|, i.e. as if the moves that took the origin
+  // to |delta| were made from here.
+  void Offset(const Coord& delta) {
+    x += delta.x;
+    y += delta.y;
+  }
+
   // Returns how many steps (hexes) away from the origin the coordinate
   // currently is.
-  int StepsFromOrigin() const {
+  std::int64_t StepsFromOrigin() const {
     // Each column we traverse horizontally takes us diagonally, and thus can
     // account for a delta of up to 1 in the y coordinate.  (We can always
     // alternate "n"- and "s"-diagonal moves to avoid changing y, if we don't
     // need to move that far vertically.)
-    const int diagonal_steps = std::abs(x);
-    const int remaining_y_distance = std::max(std::abs(y) - diagonal_steps, 0);
+    const std::int64_t diagonal_steps = std::abs(x);
+    const std::int64_t remaining_y_distance =
+        std::max(std::abs(y) - diagonal_steps, std::int64_t(0));
 
     // Once we've reached the desired column, the desired y coordinate is a
     // multiple of 2 away, since adjacent hexes within a column are two units
@@ -49,30 +77,271 @@ public:
   }
 
 private:
-  int x = 0, y = 0;
+  // These are 64-bit since paths several gigabytes long can take us more than
+  // 2^31 units away.
+  std::int64_t x = 0, y = 0;
 };
 
-// Returns the distance from the origin travelled by the path |input|.  In part
-// 1, this is the net distance; in part 2, the furthest distance away.
-int GetDistance(const std::string& input) {
+// Returns the distances from the origin travelled by the path |input|: the net
+// distance, for part 1, and the furthest distance away, for part 2.
+std::tuple<std::int64_t, std::int64_t> GetDistance(const std::string& input) {
   std::istringstream stringstream(input);
   Coord coord;
-  int max_steps = 0;
+  std::int64_t max_steps = 0;
   for (std::string direction; std::getline(stringstream, direction, ','); ) {
     coord.Move(direction);
     max_steps = std::max(max_steps, coord.StepsFromOrigin());
   }
-  return kPart1 ? coord.StepsFromOrigin() : max_steps;
+  return {coord.StepsFromOrigin(), max_steps};
+}
+
+// A decoded direction: the coordinate deltas for a move in that direction, and
+// the number of bytes the direction and its trailing comma occupy.
+struct Step {
+  int delta_x, delta_y;
+  std::ptrdiff_t length;
+};
+
+// The Steps for each direction, indexed by StepIndex().
+constexpr Step kSteps[8] = {
+  {0, 2, 2},    // "n" followed by ',' or the terminating '\0'.
+  {1, 1, 3},    // "ne"
+  {0, 2, 2},    // "n\n"
+  {-1, 1, 3},   // "nw"
+  {0, -2, 2},   // "s" followed by ',' or the terminating '\0'.
+  {1, -1, 3},   // "se"
+  {0, -2, 2},   // "s\n"
+  {-1, -1, 3},  // "sw"
+};
+
+// Returns the index into kSteps of the direction at |direction|.  This is a
+// perfect hash of the first two bytes: the low bit of the first byte separates
+// 'n' (0x6e) from 's' (0x73), and the low two bits of the second byte separate
+// ',' or '\0' (0), 'e' (1), '\n' (2) and 'w' (3).  So the byte after a
+// single-character direction must be readable, which it always is, since it's
+// either a comma or the terminator of the input string.
+inline std::size_t StepIndex(const char* direction) {
+  return (static_cast<std::size_t>(direction[0] & 1) << 2) |
+         static_cast<std::size_t>(direction[1] & 3);
+}
+
+// Calls |func| with the Step for each comma-delimited direction in
+// [begin, end), which must be followed by a comma or '\0'.
+template<typename Func>
+void DecodeMoves(const char* begin, const char* end, Func func) {
+  const char* direction = begin;
+#if defined(__SSE2__)
+  // Find the commas sixteen bytes at a time.  Each one starts a new direction,
+  // so the directions within a block can be looked up independently instead of
+  // each waiting for the previous one's length.  The first direction has no
+  // comma before it and is handled up front.
+  if (direction < end)
+    func(kSteps[StepIndex(direction)]);
+  const __m128i commas = _mm_set1_epi8(',');
+  for (; (end - direction) >= 16; direction += 16) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(direction));
+    for (unsigned mask = static_cast<unsigned>(
+             _mm_movemask_epi8(_mm_cmpeq_epi8(block, commas)));
+         mask; mask &= mask - 1) {
+      const char* const next = direction + __builtin_ctz(mask) + 1;
+      if (next < end)
+        func(kSteps[StepIndex(next)]);
+    }
+  }
+  // Finish off the last partial block a byte at a time, skipping to the start
+  // of the next direction not yet decoded.
+  direction = std::find(direction, end, ',');
+  if (direction < end)
+    ++direction;
+#endif
+  while (direction < end) {
+    const Step& step = kSteps[StepIndex(direction)];
+    func(step);
+    direction += step.length;
+  }
+}
+
+// Like GetDistance(), but splits |input| into chunks that are walked in
+// parallel on up to |threads| threads (or one per hardware thread if |threads|
+// is 0).  The result is identical to GetDistance()'s, except that if
+// |furthest| is false, the furthest distance, which takes a second pass over
+// the chunks, isn't computed and is returned as 0.
+std::tuple<std::int64_t, std::int64_t> GetDistanceParallel(
+    const std::string& input,
+    unsigned threads = 0,
+    bool furthest = true) {
+  // Don't bother splitting off chunks so small that starting a thread costs
+  // more than walking them.
+  constexpr std::size_t kMinChunkSize = 1 << 16;
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  const std::size_t chunks = std::max<std::size_t>(
+      std::min<std::size_t>(threads, input.size() / kMinChunkSize), 1);
+
+  // Chunk i is [bounds[i], bounds[i + 1]).  Each boundary is moved to just past
+  // the next comma so that no move straddles two chunks.
+  const char* const begin = input.data();
+  const char* const end = begin + input.size();
+  std::vector<const char*> bounds = {begin};
+  for (std::size_t i = 1; i < chunks; ++i) {
+    const char* const bound = std::find(
+        std::max(bounds.back(), begin + input.size() / chunks * i), end, ',');
+    bounds.push_back((bound == end) ? end : (bound + 1));
+  }
+  bounds.push_back(end);
+
+  // Runs func(i) for each chunk i, each on its own thread.
+  const auto ForEachChunk = [chunks](auto func) {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < chunks; ++i)
+      workers.emplace_back(func, i);
+    func(0);
+    for (auto& worker : workers)
+      worker.join();
+  };
+
+  // First pass: reduce each chunk to its net displacement.
+  std::vector<Coord> starts(chunks);
+  ForEachChunk([&bounds, &starts](std::size_t i) {
+    Coord displacement;
+    DecodeMoves(bounds[i], bounds[i + 1], [&displacement](const Step& step) {
+      displacement.Move(step.delta_x, step.delta_y);
+    });
+    starts[i] = displacement;
+  });
+
+  // Scan the displacements so each chunk knows where it starts.  The end of
+  // the last chunk is where the whole path ends.
+  Coord position;
+  for (Coord& start : starts) {
+    const Coord displacement = start;
+    start = position;
+    position.Offset(displacement);
+  }
+  if (!furthest)
+    return {position.StepsFromOrigin(), 0};
+
+  // Second pass: walk each chunk again from its starting point, tracking the
+  // furthest distance reached.
+  std::vector<std::int64_t> max_steps(chunks);
+  ForEachChunk([&bounds, &starts, &max_steps](std::size_t i) {
+    Coord coord = starts[i];
+    std::int64_t chunk_max_steps = 0;
+    DecodeMoves(bounds[i], bounds[i + 1],
+                [&coord, &chunk_max_steps](const Step& step) {
+                  coord.Move(step.delta_x, step.delta_y);
+                  chunk_max_steps =
+                      std::max(chunk_max_steps, coord.StepsFromOrigin());
+                });
+    max_steps[i] = chunk_max_steps;
+  });
+  return {position.StepsFromOrigin(),
+          *std::max_element(max_steps.begin(), max_steps.end())};
 }
 
 }  // namespace
 
+namespace day11 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  // The moves are decoded as they're walked, so parsing only finds the path.
+  std::string path;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    path = input.substr(0, input.find('\n'));
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  const bool furthest = options::WantsPart2(part);
+  const auto distances = GetDistanceParallel(path, 0, furthest);
+  return {std::to_string(std::get<0>(distances)),
+          furthest ? std::to_string(std::get<1>(distances)) : std::string()};
+}
+
+// Returns a comma-separated path of |moves| directions chosen at random.
+std::string GeneratePath(std::size_t moves) {
+  constexpr const char* kDirections[] = {"n", "ne", "se", "s", "sw", "nw"};
+  std::mt19937 generator(2017);
+  std::uniform_int_distribution<std::size_t> distribution(0, 5);
+  std::string path;
+  path.reserve(moves * 3);
+  for (std::size_t i = 0; i < moves; ++i) {
+    if (i)
+      path += ',';
+    path += kDirections[distribution(generator)];
+  }
+  return path;
+}
+
+// Times GetDistance() and GetDistanceParallel(), with one thread and with all
+// of them, on a generated path, and reports moves per second for each.
+void RunBenchmarks() {
+  constexpr std::size_t kMoves = 50000000;
+  const std::string path = GeneratePath(kMoves);
+  const auto expected = GetDistance(path);
+  const auto Report = [&path, &expected](const char* name, auto func) {
+    std::tuple<std::int64_t, std::int64_t> result;
+    const double seconds =
+        benchmark::MedianSeconds([&path, &func, &result]() {
+          result = func(path);
+        }, 3);
+    std::cout << name << ": " << seconds * 1000 << " ms, "
+              << kMoves / seconds << " moves/s"
+              << ((result == expected) ? "" : " (MISMATCH)") << std::endl;
+  };
+  Report("GetDistance()", GetDistance);
+  Report("GetDistanceParallel(), 1 thread",
+         [](const std::string& path) { return GetDistanceParallel(path, 1); });
+  Report("GetDistanceParallel(), all threads",
+         [](const std::string& path) { return GetDistanceParallel(path); });
+}
+
+// Times GetDistance() and GetDistanceParallel() on paths of 8,000 moves, about
+// the puzzle's length, times each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleMoves = 8000;
+  for (std::size_t scale : suite->Scales(10000)) {
+    const std::size_t moves = kPuzzleMoves * scale;
+    const std::string path = GeneratePath(moves);
+    suite->Run("GetDistance()", scale, moves, "moves",
+               [&path]() { return GetDistance(path); });
+    suite->Run("GetDistanceParallel()", scale, moves, "moves",
+               [&path]() { return GetDistanceParallel(path); });
+  }
+}
+
+}  // namespace day11
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day11::RunBenchmarks();
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter path: ";
   std::string input;
-  std::getline(std::cin, input);
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::getline(std::cin, input);
+  }
 
-  std::cout << "Steps away: " << GetDistance(input) << std::endl;
+  const solver::Answers answers = day11::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Steps away: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Steps away: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(11);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
@@ -1,47 +1,105 @@
 // Advent of Code 2017 day 12 solution
 // Peter Kasting, Dec. 11, 2017
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <numeric>
 #include <queue>
+#include <random>
 #include <regex>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "numbers.h"
+#include "options.h"
+#include "solver.h"
+
 namespace {
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+// Program IDs.  32 bits is plenty, and halves the size of a graph with tens of
+// millions of programs compared to using size_t.
+using Program = std::uint32_t;
 
-// Converts the input, a series of lines giving the connections between
-// programs, into a vector of the connected programs for each program.  Lines
-// are assumed to be in ascending order.
-std::vector<std::vector<std::size_t>> ProcessInput() {
-  std::string input;
-  std::vector<std::vector<std::size_t>> connections;
-  const std::regex regex("\\d+");
-  for (std::size_t program = 0; std::getline(std::cin, input); ++program) {
-    connections.resize(program + 1);
-
-    // Match numbers within the line, throwing away everything else as
-    // delimiters.
-    std::sregex_iterator i(input.begin(), input.end(), regex);
-    // Skip the first number, which should be |program|.
-    for (++i; i != std::sregex_iterator(); ++i) {
-      std::size_t connected = static_cast<std::size_t>(std::stoi(i->str()));
-      connections[program].push_back(connected);
-    }
-  }
-  return connections;
+// The connections between programs, in compressed sparse row form: the
+// programs connected to program p are targets[offsets[p]] through
+// targets[offsets[p + 1] - 1].  This keeps the whole graph in two allocations,
+// instead of one per program.
+struct Graph {
+  std::size_t size() const { return offsets.size() - 1; }
+
+  std::vector<std::size_t> offsets = {0};
+  std::vector<Program> targets;
+};
+
+// Builds a Graph from the connections enumerated by |for_each_connection|,
+// which is called twice, and must each time call the function it's passed
+// with every (program, connected program) pair.  The first pass counts each
+// program's connections and the second fills them in.
+template<typename ForEachConnection>
+Graph BuildGraph(ForEachConnection for_each_connection) {
+  Graph graph;
+  std::vector<std::size_t>& offsets = graph.offsets;
+  for_each_connection([&offsets](Program program, Program connected) {
+    const std::size_t min_size = std::size_t(std::max(program, connected)) + 2;
+    if (offsets.size() < min_size)
+      offsets.resize(min_size, 0);
+    ++offsets[program + 1];
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  // |next| tracks where the next connection for each program goes.
+  graph.targets.resize(offsets.back());
+  std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+  for_each_connection([&graph, &next](Program program, Program connected) {
+    graph.targets[next[program]++] = connected;
+  });
+  return graph;
+}
+
+// Calls |func| with each (program, connected program) pair in |line|, which
+// gives the connections of the program whose number comes first on the line.
+template<typename Func>
+void ForEachLineConnection(std::string_view line, Func func) {
+  // Extract numbers within the line, throwing away everything else as
+  // delimiters.
+  Program program, connected;
+  if (!numbers::NextNumber(&line, &program))
+    return;
+  while (numbers::NextNumber(&line, &connected))
+    func(program, connected);
+}
+
+// Calls |func| with each (program, connected program) pair in |input|, a
+// series of lines giving the connections between programs.
+template<typename Func>
+void ForEachConnection(std::string_view input, Func func) {
+  for (std::string_view line; numbers::NextLine(&input, &line); )
+    ForEachLineConnection(line, func);
+}
+
+// Converts |input|, a series of lines giving the connections between programs,
+// into a Graph.
+Graph ProcessInput(const std::string& input) {
+  return BuildGraph([&input](auto func) { ForEachConnection(input, func); });
 }
 
 // Returns the number of connected programs in the group beginning with
-// |first_elem|.  |connections| gives the connections between each program.
+// |first_elem|.  |graph| gives the connections between each program.
 // |found_group| is updated to flag all programs found to be part of this group.
-std::size_t ProcessGroup(
-    std::size_t first_elem,
-    const std::vector<std::vector<std::size_t>>& connections,
-    std::vector<bool>* found_group) {
+std::size_t ProcessGroup(std::size_t first_elem,
+                         const Graph& graph,
+                         std::vector<bool>* found_group) {
   std::size_t group_size = 0;
   std::queue<std::size_t> processing;  // All the connected programs whose
                                        // connections we have yet to trace.
@@ -49,7 +107,9 @@ std::size_t ProcessGroup(
     const std::size_t program = processing.front();
     // Every connected program not already part of this group is added to the
     // group, and all its connections appended to the processing queue.
-    for (std::size_t candidate : connections[program]) {
+    for (std::size_t i = graph.offsets[program];
+         i < graph.offsets[program + 1]; ++i) {
+      const Program candidate = graph.targets[i];
       if (!(*found_group)[candidate]) {
         (*found_group)[candidate] = true;
         processing.push(candidate);
@@ -71,36 +131,565 @@ std::size_t GetUngroupedElemAfter(std::size_t elem,
   return elem;
 }
 
-// Returns the number of groups partitioning |connections|.
-std::size_t CountGroups(
-    const std::vector<std::vector<std::size_t>>& connections,
-    std::vector<bool>* found_group) {
+// Returns the number of groups partitioning |graph|.
+std::size_t CountGroups(const Graph& graph, std::vector<bool>* found_group) {
   std::size_t groups = 0;
-  for (std::size_t first_elem = 0; first_elem < connections.size();
+  for (std::size_t first_elem = 0; first_elem < graph.size();
        first_elem = GetUngroupedElemAfter(first_elem, *found_group)) {
-    ProcessGroup(first_elem, connections, found_group);
+    ProcessGroup(first_elem, graph, found_group);
     ++groups;
   }
   return groups;
 }
 
+// A partition of programs into disjoint sets, which are merged by rank and
+// searched with path halving, so that both operations are effectively O(1).
+class DisjointSets {
+ public:
+  explicit DisjointSets(std::size_t size);
+
+  // Adds singleton sets for programs up through |size| - 1, if there aren't
+  // sets for them already.
+  void Grow(std::size_t size);
+
+  // Returns the representative program of the set containing |program|.
+  Program Find(Program program);
+
+  // Merges the sets containing |a| and |b|.
+  void Union(Program a, Program b);
+
+  // Returns whether |a| and |b| are in the same set.  Either may be beyond
+  // size(), in which case it's in a singleton set.
+  bool Connected(Program a, Program b);
+
+  std::size_t size() const { return parents_.size(); }
+  std::size_t sets() const { return sets_; }
+
+  // Returns the number of programs in the set containing |program|.
+  std::size_t SetSize(Program program) { return sizes_[Find(program)]; }
+
+ private:
+  std::vector<Program> parents_;
+  std::vector<std::uint8_t> ranks_;  // Ranks are at most log2(size).
+  std::vector<std::size_t> sizes_;   // Only valid for representatives.
+  std::size_t sets_;
+};
+
+DisjointSets::DisjointSets(std::size_t size)
+    : parents_(size), ranks_(size, 0), sizes_(size, 1), sets_(size) {
+  std::iota(parents_.begin(), parents_.end(), 0);
+}
+
+void DisjointSets::Grow(std::size_t size) {
+  const std::size_t old_size = parents_.size();
+  if (size <= old_size)
+    return;
+  parents_.resize(size);
+  std::iota(parents_.begin() + old_size, parents_.end(),
+            static_cast<Program>(old_size));
+  ranks_.resize(size, 0);
+  sizes_.resize(size, 1);
+  sets_ += size - old_size;
+}
+
+Program DisjointSets::Find(Program program) {
+  // Point every other program along the path at its grandparent as we go,
+  // which roughly halves the path length each time it's walked.
+  while (parents_[program] != program) {
+    parents_[program] = parents_[parents_[program]];
+    program = parents_[program];
+  }
+  return program;
+}
+
+void DisjointSets::Union(Program a, Program b) {
+  a = Find(a);
+  b = Find(b);
+  if (a == b)
+    return;
+
+  // Hang the shallower tree beneath the deeper one, so trees only grow deeper
+  // when merging two of equal rank.
+  if (ranks_[a] < ranks_[b])
+    std::swap(a, b);
+  parents_[b] = a;
+  if (ranks_[a] == ranks_[b])
+    ++ranks_[a];
+  sizes_[a] += sizes_[b];
+  --sets_;
+}
+
+bool DisjointSets::Connected(Program a, Program b) {
+  if ((a >= size()) || (b >= size()))
+    return a == b;
+  return Find(a) == Find(b);
+}
+
+// Returns the number of groups partitioning |graph| and the number of programs
+// in the group containing program 0, computed in a single sweep over the
+// connections in |graph|.  This is an alternative to ProcessGroup() and
+// CountGroups() that doesn't need to repeatedly search for ungrouped programs.
+std::pair<std::size_t, std::size_t> UnionFindGroups(const Graph& graph) {
+  DisjointSets sets(graph.size());
+  for (Program program = 0; program < graph.size(); ++program) {
+    for (std::size_t i = graph.offsets[program];
+         i < graph.offsets[program + 1]; ++i)
+      sets.Union(program, graph.targets[i]);
+  }
+  return {sets.sets(), graph.size() ? sets.SetSize(0) : 0};
+}
+
+// Like UnionFindGroups(), but sweeps the connections on |threads| threads (or
+// one per hardware thread if |threads| is 0).  The threads share one lock-free
+// disjoint-set forest: roots are linked with a compare-and-swap, always
+// beneath the smaller-numbered root, so concurrent links can never form a
+// cycle, and a failed swap just means another thread got there first and the
+// union should be retried from the new roots.
+std::pair<std::size_t, std::size_t> ParallelUnionFindGroups(
+    const Graph& graph,
+    unsigned threads = 0) {
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  const std::size_t size = graph.size();
+
+  // Runs func(i, begin, end) for each of the |threads| slices of programs,
+  // each on its own thread, where slice i is [bound(i), bound(i + 1)).
+  const auto RunSlices = [threads](auto bound, auto func) {
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; ++i)
+      workers.emplace_back(func, i, bound(i), bound(i + 1));
+    func(0, bound(0), bound(1));
+    for (auto& worker : workers)
+      worker.join();
+  };
+  // Slices with equal numbers of programs.
+  const auto ProgramBound = [threads, size](unsigned i) {
+    return size / threads * i + std::min<std::size_t>(i, size % threads);
+  };
+  // Slices with roughly equal numbers of connections.
+  const auto ConnectionBound = [threads, &graph, size](unsigned i) {
+    if (i == 0)
+      return std::size_t(0);
+    if (i == threads)
+      return size;
+    const std::size_t target = graph.targets.size() / threads * i;
+    return static_cast<std::size_t>(
+        std::upper_bound(graph.offsets.begin(), graph.offsets.end(), target) -
+        graph.offsets.begin() - 1);
+  };
+
+  std::vector<std::atomic<Program>> parents(size);
+  RunSlices(ProgramBound,
+            [&parents](unsigned, std::size_t begin, std::size_t end) {
+    for (std::size_t program = begin; program < end; ++program)
+      parents[program].store(static_cast<Program>(program));
+  });
+
+  // Path halving as in DisjointSets::Find().  A failed swap is harmless; it
+  // only means someone else already shortened the path.
+  const auto Find = [&parents](Program program) {
+    for (Program parent; (parent = parents[program]) != program; ) {
+      const Program grandparent = parents[parent];
+      if (parent != grandparent)
+        parents[program].compare_exchange_weak(parent, grandparent);
+      program = grandparent;
+    }
+    return program;
+  };
+
+  RunSlices(ConnectionBound, [&graph, &parents, &Find](unsigned,
+                                                       std::size_t begin,
+                                                       std::size_t end) {
+    for (std::size_t program = begin; program < end; ++program) {
+      for (std::size_t i = graph.offsets[program];
+           i < graph.offsets[program + 1]; ++i) {
+        for (Program a = Find(static_cast<Program>(program)),
+                     b = Find(graph.targets[i]); a != b;
+             a = Find(a), b = Find(b)) {
+          if (a < b)
+            std::swap(a, b);
+          Program expected = a;
+          if (parents[a].compare_exchange_strong(expected, b))
+            break;
+        }
+      }
+    }
+  });
+
+  // Since roots are always the smallest program in their set, program 0 is the
+  // root of its own group; count the roots and the programs whose root is 0.
+  std::vector<std::pair<std::size_t, std::size_t>> counts(threads);
+  RunSlices(ProgramBound, [&counts, &Find](unsigned slice, std::size_t begin,
+                                           std::size_t end) {
+    std::size_t roots = 0, group_size = 0;
+    for (std::size_t program = begin; program < end; ++program) {
+      const Program root = Find(static_cast<Program>(program));
+      roots += (root == program) ? 1 : 0;
+      group_size += (root == 0) ? 1 : 0;
+    }
+    counts[slice] = {roots, group_size};
+  });
+  std::pair<std::size_t, std::size_t> groups(0, 0);
+  for (const auto& count : counts) {
+    groups.first += count.first;
+    groups.second += count.second;
+  }
+  return groups;
+}
+
 }  // namespace
 
+namespace day12 {
+
+solver::Answers Solve(const std::string& input, options::Part) {
+  Graph graph;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    graph = ProcessInput(input);
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  const auto groups = ParallelUnionFindGroups(graph);
+  // In part 1, we want the size of the first group (the group containing
+  // element 0); in part 2, the number of groups.  The same pass finds both.
+  return {std::to_string(groups.second), std::to_string(groups.first)};
+}
+
+// Adds the connections in |lines| to |sets|, growing it to cover any programs
+// not seen before.
+void AddConnections(const std::vector<std::string>& lines, DisjointSets* sets) {
+  for (const std::string& line : lines) {
+    ForEachLineConnection(line, [sets](Program program, Program connected) {
+      sets->Grow(std::size_t(std::max(program, connected)) + 1);
+      sets->Union(program, connected);
+    });
+  }
+}
+
+// Reads program data from std::cin as it arrives, and maintains the groups
+// incrementally instead of recomputing them from scratch.  Connection lines are
+// buffered until a blank line, then applied as a batch, after which the batch's
+// update time is printed, along with the size of program 0's group if |part|
+// includes part 1 and the number of groups if it includes part 2.  A line of
+// the form "? a b" asks whether programs a and b are connected, after applying
+// any buffered connections.  Programs not yet seen in any connection count as
+// singleton groups if their numbers are lower than the highest program seen so
+// far.
+void ProcessStream(options::Part part) {
+  DisjointSets sets(0);
+  std::vector<std::string> batch;
+  std::size_t batches = 0;
+  const auto ApplyBatch = [part, &sets, &batch, &batches]() {
+    if (batch.empty())
+      return;
+    const auto start = std::chrono::steady_clock::now();
+    AddConnections(batch, &sets);
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "Batch " << ++batches << ": " << batch.size()
+              << " lines applied in " << elapsed.count() << " us";
+    if (options::WantsPart1(part)) {
+      std::cout << "; connected programs: "
+                << (sets.size() ? sets.SetSize(0) : 0);
+    }
+    if (options::WantsPart2(part))
+      std::cout << "; groups: " << sets.sets();
+    std::cout << std::endl;
+    batch.clear();
+  };
+
+  for (std::string line; std::getline(std::cin, line); ) {
+    if (line.empty()) {
+      ApplyBatch();
+    } else if (line[0] == '?') {
+      ApplyBatch();
+      ForEachLineConnection(line, [&sets](Program a, Program b) {
+        std::cout << a << " and " << b << ": "
+                  << (sets.Connected(a, b) ? "connected" : "not connected")
+                  << std::endl;
+      });
+    } else {
+      batch.push_back(line);
+    }
+  }
+  ApplyBatch();
+}
+
+// Calls |func| with each of |connections| random two-way connections between
+// |programs| programs.  Every program is also connected to itself, as isolated
+// programs are in the puzzle input.
+template<typename Func>
+void ForEachGeneratedConnection(std::size_t programs,
+                                std::size_t connections,
+                                Func func) {
+  std::mt19937_64 generator(2017);
+  std::uniform_int_distribution<Program> distribution(
+      0, static_cast<Program>(programs - 1));
+  for (Program program = 0; program < programs; ++program)
+    func(program, program);
+  for (std::size_t i = 0; i < connections; ++i) {
+    const Program a = distribution(generator), b = distribution(generator);
+    func(a, b);
+    func(b, a);
+  }
+}
+
+// Returns a Graph of the connections from ForEachGeneratedConnection().
+Graph GenerateGraph(std::size_t programs, std::size_t connections) {
+  // Rather than storing the random connections, regenerate the same sequence
+  // for each of BuildGraph()'s passes.
+  return BuildGraph([programs, connections](auto func) {
+    ForEachGeneratedConnection(programs, connections, func);
+  });
+}
+
+// Streams generated connections into a DisjointSets in fixed-size batches,
+// reporting the median and worst per-batch update latency and the rate of
+// connectivity queries between batches, and checks the final groups against
+// UnionFindGroups().
+void BenchmarkStreaming() {
+  constexpr std::size_t kPrograms = 1000000;
+  constexpr std::size_t kConnections = 3000000;
+  constexpr std::size_t kBatchSize = 10000;
+  constexpr std::size_t kQueriesPerBatch = 1000;
+  DisjointSets sets(0);
+  std::vector<std::pair<Program, Program>> batch;
+  std::vector<double> latencies;
+  double query_seconds = 0;
+  std::size_t queries = 0, connected = 0;
+  std::mt19937 query_generator(12);
+  std::uniform_int_distribution<Program> query_distribution(
+      0, static_cast<Program>(kPrograms - 1));
+  const auto ApplyBatch = [&]() {
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& pair : batch) {
+      sets.Grow(std::size_t(std::max(pair.first, pair.second)) + 1);
+      sets.Union(pair.first, pair.second);
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    latencies.push_back(elapsed.count());
+    batch.clear();
+
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < kQueriesPerBatch; ++i) {
+      connected += sets.Connected(query_distribution(query_generator),
+                                  query_distribution(query_generator));
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    query_seconds += elapsed.count();
+    queries += kQueriesPerBatch;
+  };
+  ForEachGeneratedConnection(kPrograms, kConnections,
+                             [&batch, &ApplyBatch](Program a, Program b) {
+    batch.emplace_back(a, b);
+    if (batch.size() == kBatchSize)
+      ApplyBatch();
+  });
+  if (!batch.empty())
+    ApplyBatch();
+
+  const auto expected = UnionFindGroups(GenerateGraph(kPrograms, kConnections));
+  const bool matches = (sets.sets() == expected.first) &&
+                       (sets.SetSize(0) == expected.second);
+  const std::size_t median = latencies.size() / 2;
+  std::nth_element(latencies.begin(), latencies.begin() + median,
+                   latencies.end());
+  std::cout << "Streaming " << kPrograms << " programs in batches of "
+            << kBatchSize << " connections: median batch "
+            << latencies[median] * 1e6 << " us, worst batch "
+            << *std::max_element(latencies.begin(), latencies.end()) * 1e6
+            << " us, " << queries / query_seconds << " queries/s ("
+            << connected << " connected)" << (matches ? "" : " (MISMATCH)")
+            << std::endl;
+}
+
+// Returns the puzzle-format text of GenerateGraph(programs, connections).
+std::string GenerateInput(std::size_t programs, std::size_t connections) {
+  const Graph graph = GenerateGraph(programs, connections);
+  std::ostringstream input;
+  for (std::size_t program = 0; program < graph.size(); ++program) {
+    input << program << " <->";
+    for (std::size_t i = graph.offsets[program];
+         i < graph.offsets[program + 1]; ++i)
+      input << ((i == graph.offsets[program]) ? " " : ", ") << graph.targets[i];
+    input << '\n';
+  }
+  return input.str();
+}
+
+// Converts |input| to a Graph the way ProcessInput() used to, by matching
+// numbers with a regex, for comparison.
+Graph ProcessInputWithRegex(const std::string& input) {
+  return BuildGraph([&input](auto func) {
+    std::istringstream stringstream(input);
+    const std::regex regex("\\d+");
+    for (std::string line; std::getline(stringstream, line); ) {
+      std::sregex_iterator i(line.begin(), line.end(), regex);
+      if (i == std::sregex_iterator())
+        continue;
+      const Program program = static_cast<Program>(std::stoi(i->str()));
+      for (++i; i != std::sregex_iterator(); ++i)
+        func(program, static_cast<Program>(std::stoi(i->str())));
+    }
+  });
+}
+
+// Times ProcessInput() against ProcessInputWithRegex() on generated input.
+void BenchmarkParsing() {
+  const std::string input = GenerateInput(1000000, 2000000);
+  Graph graph, regex_graph;
+  const double seconds = benchmark::MedianSeconds(
+      [&input, &graph]() { graph = ProcessInput(input); }, 3);
+  const double regex_seconds = benchmark::MedianSeconds(
+      [&input, &regex_graph]() { regex_graph = ProcessInputWithRegex(input); },
+      1);
+  const bool matches = (graph.offsets == regex_graph.offsets) &&
+                       (graph.targets == regex_graph.targets);
+  const double megabytes = input.size() / 1e6;
+  std::cout << "Parsing " << megabytes << " MB: ProcessInput() "
+            << megabytes / seconds << " MB/s, regex " << megabytes / regex_seconds
+            << " MB/s" << (matches ? "" : " (MISMATCH)") << std::endl;
+}
+
+// Times BFS (CountGroups() plus a ProcessGroup() for group 0) against
+// UnionFindGroups() on generated graphs, then shows how
+// ParallelUnionFindGroups() scales with thread count.
+void BenchmarkGroups() {
+  for (std::size_t programs : {1000000, 10000000}) {
+    const Graph graph = GenerateGraph(programs, programs);
+
+    std::size_t bfs_groups = 0, bfs_group_size = 0;
+    const double bfs_seconds = benchmark::MedianSeconds(
+        [&graph, &bfs_groups, &bfs_group_size]() {
+          std::vector<bool> found_group(graph.size(), false);
+          bfs_group_size = ProcessGroup(0, graph, &found_group);
+          found_group.assign(graph.size(), false);
+          bfs_groups = CountGroups(graph, &found_group);
+        }, 3);
+
+    std::pair<std::size_t, std::size_t> union_find_result;
+    const double union_find_seconds = benchmark::MedianSeconds(
+        [&graph, &union_find_result]() {
+          union_find_result = UnionFindGroups(graph);
+        }, 3);
+
+    const bool matches = (union_find_result.first == bfs_groups) &&
+                         (union_find_result.second == bfs_group_size);
+    std::cout << programs << " programs, " << graph.targets.size()
+              << " connections: BFS " << bfs_seconds * 1000
+              << " ms, union-find " << union_find_seconds * 1000 << " ms ("
+              << bfs_groups << " groups, group 0 has " << bfs_group_size
+              << " programs)" << (matches ? "" : " (MISMATCH)") << std::endl;
+  }
+
+  // Scale ParallelUnionFindGroups() from one thread up to one per hardware
+  // thread on 100M random connections, checking each result against BFS.
+  constexpr std::size_t kPrograms = 20000000;
+  constexpr std::size_t kConnections = 100000000;
+  const Graph graph = GenerateGraph(kPrograms, kConnections);
+  std::vector<bool> found_group(graph.size(), false);
+  const std::size_t bfs_group_size = ProcessGroup(0, graph, &found_group);
+  found_group.assign(graph.size(), false);
+  const std::size_t bfs_groups = CountGroups(graph, &found_group);
+  const unsigned max_threads =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+    std::pair<std::size_t, std::size_t> result;
+    const double seconds = benchmark::MedianSeconds(
+        [&graph, threads, &result]() {
+          result = ParallelUnionFindGroups(graph, threads);
+        }, 1);
+    const bool matches =
+        (result.first == bfs_groups) && (result.second == bfs_group_size);
+    std::cout << kPrograms << " programs, " << kConnections
+              << " random connections, " << threads << " threads: "
+              << seconds * 1000 << " ms" << (matches ? "" : " (MISMATCH)")
+              << std::endl;
+    if (threads == max_threads)
+      break;
+  }
+}
+
+void RunBenchmarks() {
+  BenchmarkParsing();
+  BenchmarkStreaming();
+  BenchmarkGroups();
+}
+
+// Times ProcessInput(), UnionFindGroups() and ParallelUnionFindGroups() on
+// 2,000 programs, the puzzle's size, times each scale, with as many random
+// connections as programs.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzlePrograms = 2000;
+  for (std::size_t scale : suite->Scales(1000)) {
+    const std::size_t programs = kPuzzlePrograms * scale;
+    const std::string input = GenerateInput(programs, programs);
+    suite->Run("ProcessInput()", scale, programs, "programs",
+               [&input]() { return ProcessInput(input).size(); });
+    const Graph graph = ProcessInput(input);
+    suite->Run("UnionFindGroups()", scale, programs, "programs",
+               [&graph]() { return UnionFindGroups(graph); });
+    suite->Run("ParallelUnionFindGroups()", scale, programs, "programs",
+               [&graph]() { return ParallelUnionFindGroups(graph); });
+  }
+}
+
+}  // namespace day12
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day12::RunBenchmarks();
+    return 0;
+  }
+
+  // Streaming reports both parts unless asked for one.  It interleaves reading
+  // with solving, so it has no phases to profile.
+  bool stream = false, profile = false;
+  for (int i = 1; i < argc; ++i) {
+    stream |= std::string_view(argv[i]) == "--stream";
+    profile |= std::string_view(argv[i]) == "--profile";
+  }
+  if (stream && profile) {
+    std::cout << "--profile can't be used with --stream." << std::endl;
+    return 1;
+  }
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part,
+                          stream ? options::Part::kBoth
+                                 : options::Part::kPart2))
+    return 1;
+
+  if (stream) {
+    std::cout << "Enter program data, with blank lines between batches and "
+                 "\"? a b\" to query; terminate with ctrl-z alone on a line."
+              << std::endl;
+    day12::ProcessStream(part);
+    return 0;
+  }
+
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter program data; terminate with ctrl-z alone on a line."
             << std::endl;
 
-  std::vector<std::vector<std::size_t>> connections = ProcessInput();
-  std::vector<bool> found_group(connections.size(), false);
-  // In part 1, we want the size of the first group (the group containing
-  // element 0); in part 2, the number of groups.
-  if (kPart1) {
-    std::cout << "Connected programs: "
-              << ProcessGroup(0, connections, &found_group) << std::endl;
-  } else {
-    std::cout << "Groups: " << CountGroups(connections, &found_group)
-              << std::endl;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
+  const solver::Answers answers = day12::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Connected programs: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Groups: " << answers.part2 << std::endl;
   }
+  instrumentation::Report(12);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
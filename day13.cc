@@ -2,31 +2,50 @@
 // Peter Kasting, Dec. 13, 2017
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
 #include <regex>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "numbers.h"
+#include "options.h"
+#include "solver.h"
+
 namespace {
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+// A delay before the packet starts moving.  64-bit, since with enough scanners
+// the minimum safe delay can run into the billions.
+using Delay = std::uint64_t;
 
 // Tokenizes |input|, a string representing a single scanner's depth and range,
 // into a pair of (depth, range).
-std::pair<int, int> ParseScanner(const std::string& input) {
-  const std::regex regex("\\d+");
-  std::sregex_iterator i(input.begin(), input.end(), regex);
-  const int depth = std::stoi(i->str());
-  ++i;
-  return {depth, std::stoi(i->str())};
+std::pair<int, int> ParseScanner(std::string_view input) {
+  std::pair<int, int> scanner(0, 0);
+  numbers::NextNumber(&input, &scanner.first);
+  numbers::NextNumber(&input, &scanner.second);
+  return scanner;
 }
 
 // Returns whether a packet beginning at |delay| would be detected by |scanner|.
-bool Detected(int delay, const std::pair<int, int>& scanner) {
-  // The period of a scanner is 2 * (range - 1).
-  return ((scanner.first + delay) % (2 * (scanner.second - 1))) == 0;
+bool Detected(Delay delay, const std::pair<int, int>& scanner) {
+  // The period of a scanner is 2 * (range - 1).  A scanner of range 1 never
+  // leaves the top, and so catches everything.
+  return (scanner.second < 2) ||
+         (((scanner.first + delay) % (2 * (scanner.second - 1))) == 0);
 }
 
 // Returns the severity of a trip beginning with delay |delay|.
@@ -43,7 +62,7 @@ int GetSeverity(const std::vector<std::pair<int, int>>& scanners, int delay) {
 
 // Returns the minimum necessary delay for a packet to avoid detection by
 // |scanners|.
-int GetDelay(const std::vector<std::pair<int, int>>& scanners) {
+Delay GetDelay(const std::vector<std::pair<int, int>>& scanners) {
   // This is slow, because it is O(scanners.size()) for each delay value.  It
   // seems like we ought to be able to do better -- ideally to have the whole
   // function run in O(scanners.size()) -- but I haven't figured out how.
@@ -53,28 +72,496 @@ int GetDelay(const std::vector<std::pair<int, int>>& scanners) {
   // Theorem or Chinese Remainder Theorem would be useful, but the fact that
   // each scanner's "window" is more than one time unit wide is making it hard
   // for me to see how to apply these.
-  int delay = 0;
+  Delay delay = 0;
   while (std::any_of(scanners.begin(), scanners.end(),
                      std::bind(Detected, delay, std::placeholders::_1)))
     ++delay;
   return delay;
 }
 
+// Returned by SieveDelay() and ParallelSearch() when no delay avoids detection.
+constexpr Delay kNoSafeDelay = std::numeric_limits<Delay>::max();
+
+// Returns the smallest safe delay below |limit|, searching blocks of
+// |block_size| delays on |threads| threads (or one per hardware thread if
+// |threads| is 0).  search(begin, end, best) must return the smallest safe
+// delay in [begin, end), or kNoSafeDelay if there is none.  |best| is the
+// smallest safe delay any thread has found so far; |search| may give up and
+// return kNoSafeDelay once it's past that, since it can no longer win.
+//
+// Threads claim blocks from a shared counter, so blocks are started in order,
+// and a thread only stops claiming once the next block starts past the best
+// delay found.  So by the time all threads finish, every delay below the best
+// has been checked, and the result doesn't depend on the thread count or
+// timing.
+template<typename Search>
+Delay ParallelSearch(Delay block_size,
+                     Delay limit,
+                     unsigned threads,
+                     Search search) {
+  std::atomic<Delay> next_block(0), best(kNoSafeDelay);
+  const auto Work = [block_size, limit, &search, &next_block, &best]() {
+    while (true) {
+      const Delay begin = next_block.fetch_add(1) * block_size;
+      if (begin >= std::min(limit, best.load()))
+        return;
+      const Delay found =
+          search(begin, std::min(begin + block_size, limit), best);
+      // Lower |best| to |found|, unless another thread has already found
+      // something smaller.
+      for (Delay current = best.load();
+           (found < current) && !best.compare_exchange_weak(current, found); ) {
+      }
+    }
+  };
+
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; ++i)
+    workers.emplace_back(Work);
+  Work();
+  for (auto& worker : workers)
+    worker.join();
+  return best;
+}
+
+// Like GetDelay(), but tests blocks of delays in parallel on |threads| threads
+// (or one per hardware thread if |threads| is 0).
+Delay ParallelGetDelay(const std::vector<std::pair<int, int>>& scanners,
+                       unsigned threads = 0) {
+  // Blocks are big enough that claiming them is rare, and workers check every
+  // few thousand delays whether another thread has already won.
+  constexpr Delay kBlockSize = 1 << 20;
+  constexpr Delay kCancelCheckInterval = 1 << 12;
+  return ParallelSearch(kBlockSize, kNoSafeDelay, threads,
+                        [&scanners](Delay begin, Delay end,
+                                    const std::atomic<Delay>& best) {
+    for (Delay delay = begin; delay < end; ++delay) {
+      if (!(delay % kCancelCheckInterval) && (delay >= best.load()))
+        return kNoSafeDelay;
+      if (std::none_of(scanners.begin(), scanners.end(),
+                       std::bind(Detected, delay, std::placeholders::_1)))
+        return delay;
+    }
+    return kNoSafeDelay;
+  });
+}
+
+// Returns the same delay as GetDelay(), by sieving rather than testing every
+// delay against every scanner.  The sieving is spread across |threads| threads
+// (or one per hardware thread if |threads| is 0).
+//
+// The key is that a scanner with depth d and period p catches exactly the
+// delays congruent to -d (mod p), a single residue.  So scanners sharing a
+// period can be merged into one set of forbidden residues for that period.
+//
+// Whether a delay is safe from the scanners with periods p1, p2, ... then
+// depends only on the delay mod L = lcm(p1, p2, ...), so, in the style of the
+// Chinese Remainder Theorem, the small periods are combined into a "wheel" of
+// the residues mod L that are safe from all of them.  Only delays on the wheel
+// need to be considered against the remaining periods.  If L is small, the
+// wheel is laid out as a bit pattern over a block of delays, and the remaining
+// periods' forbidden residues are struck out of each block in strides of p,
+// which costs (block size / p) per forbidden residue rather than (block size)
+// per scanner.  If L is large, the safe residues are sparse, and it's cheaper
+// to walk the wheel and look up each candidate's residue in the remaining
+// periods.
+Delay SieveDelay(const std::vector<std::pair<int, int>>& scanners,
+                 unsigned threads = 0) {
+  // Merge the forbidden residues of scanners by period.  |periods| is ordered
+  // by increasing period, which is the order they join the wheel below.
+  std::map<Delay, std::vector<bool>> periods;
+  for (const auto& scanner : scanners) {
+    // A scanner of range 1 never leaves the top, and so catches everything.
+    if (scanner.second < 2)
+      return kNoSafeDelay;
+    const Delay period = 2 * static_cast<Delay>(scanner.second - 1);
+    std::vector<bool>& forbidden = periods[period];
+    forbidden.resize(period, false);
+    forbidden[(period - static_cast<Delay>(scanner.first) % period) % period] =
+        true;
+  }
+
+  // Every scanner's position repeats within the LCM of all the periods, so if
+  // no delay below that is safe, none is.  The LCM saturates instead of
+  // overflowing, making the search effectively unbounded.
+  Delay search_limit = 1;
+  for (const auto& period : periods) {
+    const Delay factor = period.first / std::gcd(search_limit, period.first);
+    search_limit = (search_limit > (kNoSafeDelay / factor))
+                       ? kNoSafeDelay
+                       : (search_limit * factor);
+  }
+
+  // Build the wheel, adding periods for as long as the list of safe residues
+  // stays small enough to walk and the modulus fits in a Delay, with the same
+  // saturation check as |search_limit|.  Since each period is added by
+  // extending the previous residues across the new modulus in order,
+  // |residues| stays sorted.
+  constexpr std::size_t kMaxWheelResidues = 1 << 16;
+  Delay modulus = 1;
+  std::vector<Delay> residues = {0};
+  auto remaining = periods.cbegin();
+  for (; remaining != periods.cend(); ++remaining) {
+    const Delay period = remaining->first;
+    const Delay factor = period / std::gcd(modulus, period);
+    if ((modulus > (kNoSafeDelay / factor)) ||
+        ((residues.size() * factor) > kMaxWheelResidues))
+      break;
+    const Delay lcm = modulus * factor;
+    std::vector<Delay> safe_residues;
+    for (Delay base = 0; base < lcm; base += modulus) {
+      for (Delay residue : residues) {
+        if (!remaining->second[(base + residue) % period])
+          safe_residues.push_back(base + residue);
+      }
+    }
+    // If nothing is safe from these periods, nothing ever will be.
+    if (safe_residues.empty())
+      return kNoSafeDelay;
+    residues.swap(safe_residues);
+    modulus = lcm;
+  }
+  if (remaining == periods.cend())
+    return residues.front();
+
+  // Returns whether |delay| is safe from the periods not on the wheel.
+  const auto SafeFromRemaining = [&periods, remaining](Delay delay) {
+    return std::none_of(remaining, periods.cend(), [delay](const auto& period) {
+      return period.second[delay % period.first];
+    });
+  };
+  constexpr Delay kMaxPatternModulus = 1 << 16;
+  if (modulus > kMaxPatternModulus) {
+    // Each block is a number of turns of the wheel, but no more than fit in a
+    // Delay.
+    constexpr Delay kMinCandidatesPerBlock = 1 << 16;
+    const Delay turns_per_block = std::min<Delay>(
+        (kMinCandidatesPerBlock + residues.size() - 1) / residues.size(),
+        kNoSafeDelay / modulus);
+    return ParallelSearch(modulus * turns_per_block, search_limit, threads,
+                          [modulus, &residues, &SafeFromRemaining](
+                              Delay begin, Delay end,
+                              const std::atomic<Delay>& best) {
+      for (Delay base = begin; base < end; base += modulus) {
+        if (base >= best.load())
+          break;
+        for (Delay residue : residues) {
+          if (SafeFromRemaining(base + residue))
+            return base + residue;
+        }
+      }
+      return kNoSafeDelay;
+    });
+  }
+
+  // Blocks are at least a few hundred kilobits, to amortize the per-block cost
+  // of each remaining period, and a multiple of |modulus|, so every block
+  // starts at delay 0 (mod |modulus|) and can start from the wheel's pattern.
+  constexpr Delay kMinBlockSize = 1 << 18;
+  const Delay block_size =
+      (kMinBlockSize + modulus - 1) / modulus * modulus;
+  const std::size_t words = static_cast<std::size_t>((block_size + 63) / 64);
+
+  // Bit n of the pattern is set when delay n is on the wheel.
+  std::vector<std::uint64_t> pattern(words, 0);
+  for (Delay base = 0; base < block_size; base += modulus) {
+    for (Delay residue : residues) {
+      const Delay delay = base + residue;
+      pattern[delay / 64] |= std::uint64_t(1) << (delay % 64);
+    }
+  }
+
+  return ParallelSearch(block_size, search_limit, threads,
+                        [&periods, remaining, block_size, words, &pattern](
+                            Delay base, Delay, const std::atomic<Delay>&) {
+    std::vector<std::uint64_t> block = pattern;
+    for (auto period = remaining; period != periods.cend(); ++period) {
+      const Delay stride = period->first;
+      const Delay offset = base % stride;
+      for (Delay residue = 0; residue < stride; ++residue) {
+        if (!period->second[residue])
+          continue;
+        for (Delay delay = (residue + stride - offset) % stride;
+             delay < block_size; delay += stride)
+          block[delay / 64] &= ~(std::uint64_t(1) << (delay % 64));
+      }
+    }
+
+    // The lowest remaining bit, if any, is the answer.
+    for (std::size_t word = 0; word < words; ++word) {
+      if (block[word]) {
+        Delay bit = 0;
+        while (!((block[word] >> bit) & 1))
+          ++bit;
+        return base + word * 64 + bit;
+      }
+    }
+    return kNoSafeDelay;
+  });
+}
+
 }  // namespace
 
+namespace day13 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  std::vector<std::pair<int, int>> scanners;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    std::string_view remaining(input);
+    for (std::string_view line; numbers::NextLine(&remaining, &line); )
+      scanners.push_back(ParseScanner(line));
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = std::to_string(GetSeverity(scanners, 0));
+  if (options::WantsPart2(part)) {
+    const Delay delay = SieveDelay(scanners);
+    answers.part2 =
+        (delay == kNoSafeDelay) ? "no safe delay" : std::to_string(delay);
+  }
+  return answers;
+}
+
+// Returns |count| scanners at increasing depths with random ranges from 2 to
+// |max_range|.  Ranges that would catch a packet delayed by |safe_delay| are
+// rerolled, so that there is always a solution.  This resembles the puzzle
+// input.  |max_range| should be well above 2, or there may be no ranges to
+// reroll to.
+std::vector<std::pair<int, int>> GenerateRandomScanners(std::size_t count,
+                                                        int max_range,
+                                                        Delay safe_delay) {
+  std::mt19937 generator(2017);
+  std::uniform_int_distribution<int> gap_distribution(1, 3);
+  std::uniform_int_distribution<int> range_distribution(2, max_range);
+  std::vector<std::pair<int, int>> scanners;
+  for (int depth = 0; scanners.size() < count;
+       depth += gap_distribution(generator)) {
+    // Skip the depth if no range seems to miss |safe_delay|.
+    std::pair<int, int> scanner(depth, range_distribution(generator));
+    for (int tries = 0; (tries < 100) && Detected(safe_delay, scanner); ++tries)
+      scanner.second = range_distribution(generator);
+    if (!Detected(safe_delay, scanner))
+      scanners.push_back(scanner);
+  }
+  return scanners;
+}
+
+// Returns a set of scanners whose minimum safe delay is |delay|, with ranges up
+// to |max_range|, sorted into depth order.  For each range, every residue of
+// the range's period except |delay|'s gets a scanner that forbids it.  By the
+// Chinese Remainder Theorem, the only safe delays are then those congruent to
+// |delay| modulo the LCM of all the periods, which must therefore exceed
+// |delay|.  Scanners at random other depths with ranges that miss |delay| are
+// mixed in, so that not every period is fully determined by its own scanners.
+std::vector<std::pair<int, int>> GenerateScanners(int max_range, Delay delay) {
+  std::mt19937 generator(2017);
+  std::vector<std::pair<int, int>> scanners;
+  std::vector<bool> used_depths;
+  const auto AddScanner = [&scanners, &used_depths](int depth, int range) {
+    const Delay period = 2 * static_cast<Delay>(range - 1);
+    while ((static_cast<std::size_t>(depth) < used_depths.size()) &&
+           used_depths[depth])
+      depth += static_cast<int>(period);
+    if (used_depths.size() <= static_cast<std::size_t>(depth))
+      used_depths.resize(depth + 1, false);
+    used_depths[depth] = true;
+    scanners.emplace_back(depth, range);
+  };
+
+  for (int range = 2; range <= max_range; ++range) {
+    const Delay period = 2 * static_cast<Delay>(range - 1);
+    for (Delay residue = 0; residue < period; ++residue) {
+      if (residue != delay % period)
+        AddScanner(static_cast<int>((period - residue) % period), range);
+    }
+  }
+  std::uniform_int_distribution<int> range_distribution(2, max_range);
+  for (std::size_t extra = scanners.size() / 4; extra; --extra) {
+    std::pair<int, int> scanner(
+        static_cast<int>(used_depths.size() + generator() % 64), 0);
+    do
+      scanner.second = range_distribution(generator);
+    while (Detected(delay, scanner));
+    AddScanner(scanner.first, scanner.second);
+  }
+
+  std::sort(scanners.begin(), scanners.end());
+  return scanners;
+}
+
+// Parses |input| the way ParseScanner() used to, by matching numbers with a
+// regex, for comparison.
+std::pair<int, int> ParseScannerWithRegex(const std::string& input) {
+  const std::regex regex("\\d+");
+  std::sregex_iterator i(input.begin(), input.end(), regex);
+  const int depth = std::stoi(i->str());
+  ++i;
+  return {depth, std::stoi(i->str())};
+}
+
+// Times parsing 100,000 scanner lines with ParseScanner() and with
+// ParseScannerWithRegex().
+void BenchmarkParsing() {
+  std::mt19937 generator(2017);
+  std::ostringstream stream;
+  for (int depth = 0; depth < 100000; ++depth)
+    stream << depth << ": " << (generator() % 100 + 2) << '\n';
+  const std::string input = stream.str();
+
+  // Both parsers are given lines split out the same way, so only the parsing
+  // itself is compared.
+  std::vector<std::pair<int, int>> scanners, regex_scanners;
+  const double seconds = benchmark::MedianSeconds([&input, &scanners]() {
+    scanners.clear();
+    std::string_view remaining(input);
+    for (std::string_view line; numbers::NextLine(&remaining, &line); )
+      scanners.push_back(ParseScanner(line));
+  }, 3);
+  const double regex_seconds = benchmark::MedianSeconds(
+      [&input, &regex_scanners]() {
+        regex_scanners.clear();
+        std::string_view remaining(input);
+        for (std::string_view line; numbers::NextLine(&remaining, &line); )
+          regex_scanners.push_back(ParseScannerWithRegex(std::string(line)));
+      }, 1);
+  const double megabytes = input.size() / 1e6;
+  std::cout << "Parsing " << megabytes << " MB: ParseScanner() "
+            << megabytes / seconds << " MB/s, regex "
+            << megabytes / regex_seconds << " MB/s"
+            << ((scanners == regex_scanners) ? "" : " (MISMATCH)") << std::endl;
+}
+
+// Times SieveDelay() against the brute-force GetDelay() on generated scanner
+// sets.  The brute force is skipped when the answer is too large for it to
+// finish in reasonable time.
+void BenchmarkDelays() {
+  constexpr Delay kMaxBruteForceDelay = 100000000;
+  const auto Benchmark = [](const std::vector<std::pair<int, int>>& scanners,
+                            int max_range, Delay delay) {
+    Delay sieve_delay = 0;
+    const double sieve_seconds = benchmark::MedianSeconds(
+        [&scanners, &sieve_delay]() { sieve_delay = SieveDelay(scanners); });
+    std::cout << scanners.size() << " scanners, ranges up to " << max_range
+              << ": delay " << sieve_delay << ", SieveDelay() "
+              << sieve_seconds * 1000 << " ms";
+    if (delay && (sieve_delay != delay))
+      std::cout << " (MISMATCH)";
+    if (sieve_delay <= kMaxBruteForceDelay) {
+      Delay brute_force_delay = 0;
+      const double brute_force_seconds = benchmark::MedianSeconds(
+          [&scanners, &brute_force_delay]() {
+            brute_force_delay = GetDelay(scanners);
+          }, 1);
+      std::cout << ", GetDelay() " << brute_force_seconds * 1000 << " ms"
+                << ((sieve_delay == brute_force_delay) ? "" : " (MISMATCH)");
+    }
+    std::cout << std::endl;
+  };
+  // Random scanners, with unknown but moderate answers.
+  Benchmark(GenerateRandomScanners(43, 20, 4000000), 20, 0);
+  Benchmark(GenerateRandomScanners(60, 200, 4000000), 200, 0);
+  Benchmark(GenerateRandomScanners(400, 60, 40000000), 60, 0);
+  // Scanners constructed to have a known, large answer.
+  Benchmark(GenerateScanners(16, 700000), 16, 700000);
+  Benchmark(GenerateScanners(18, 20000000), 18, 20000000);
+  Benchmark(GenerateScanners(24, 10000000000), 24, 10000000000);
+  Benchmark(GenerateScanners(30, 4000000000000), 30, 4000000000000);
+
+  // Scale ParallelGetDelay() from one thread up to one per hardware thread.
+  const unsigned max_threads =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  for (Delay delay : {Delay(20000000), Delay(200000000)}) {
+    const auto scanners = GenerateScanners(20, delay);
+    for (unsigned threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+      Delay parallel_delay = 0;
+      const double seconds = benchmark::MedianSeconds(
+          [&scanners, threads, &parallel_delay]() {
+            parallel_delay = ParallelGetDelay(scanners, threads);
+          }, 1);
+      std::cout << "ParallelGetDelay(), delay " << parallel_delay << ", "
+                << threads << " threads: " << seconds * 1000 << " ms"
+                << ((parallel_delay == delay) ? "" : " (MISMATCH)")
+                << std::endl;
+      if (threads == max_threads)
+        break;
+    }
+  }
+}
+
+void RunBenchmarks() {
+  BenchmarkParsing();
+  BenchmarkDelays();
+}
+
+// Times GetSeverity() on 43 random scanners, about the puzzle's count, times
+// each scale.  Random scanners' minimum safe delays vary wildly with their
+// count, so GetDelay() and SieveDelay() are timed instead on scanners built to
+// have a known minimum safe delay of 4,000,000, about the puzzle's answer,
+// times each scale, and reported per delay searched.  GetDelay()'s work grows
+// with the delay; SieveDelay()'s barely does, which is the point of it.  Ranges
+// up to 30 give periods whose LCM, about 4.7e12, exceeds every delay used.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleScanners = 43;
+  constexpr Delay kPuzzleDelay = 4000000;
+  constexpr int kMaxRange = 30;
+  for (std::size_t scale : suite->Scales(10000)) {
+    const auto scanners =
+        GenerateRandomScanners(kPuzzleScanners * scale, 20, 4000000);
+    suite->Run("GetSeverity()", scale, scanners.size(), "scanners",
+               [&scanners]() { return GetSeverity(scanners, 0); });
+  }
+  for (std::size_t scale : suite->Scales(10)) {
+    const Delay delay = kPuzzleDelay * scale;
+    const auto scanners = GenerateScanners(kMaxRange, delay);
+    suite->Run("GetDelay()", scale, static_cast<double>(delay), "delays",
+               [&scanners]() { return GetDelay(scanners); });
+  }
+  for (std::size_t scale : suite->Scales(1000000)) {
+    const Delay delay = kPuzzleDelay * scale;
+    const auto scanners = GenerateScanners(kMaxRange, delay);
+    suite->Run("SieveDelay()", scale, static_cast<double>(delay), "delays",
+               [&scanners]() { return SieveDelay(scanners); });
+  }
+}
+
+}  // namespace day13
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day13::RunBenchmarks();
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter program data; terminate with ctrl-z alone on a line."
             << std::endl;
 
   std::string input;
-  std::vector<std::pair<int, int>> scanners;
-  while (std::getline(std::cin, input))
-    scanners.push_back(ParseScanner(input));
-
-  if (kPart1)
-    std::cout << "Severity: " << GetSeverity(scanners, 0) << std::endl;
-  else
-    std::cout << "Starting delay: " << GetDelay(scanners) << std::endl;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
+  const solver::Answers answers = day13::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Severity: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Starting delay: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(13);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
@@ -2,45 +2,51 @@
 // Peter Kasting, Dec. 14, 2017
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iostream>
 #include <numeric>
 #include <queue>
+#include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
-// Converts |input| to a series of lengths to use to compute the sparse hash.
-// This series consists of the byte values of each input character, plus a
-// suffix.
-std::vector<std::size_t> Tokenize(const std::string& input) {
+// Converts |input| to a series of lengths to use to compute the sparse hash,
+// stored in |*lengths| (whose capacity is reused).  This series consists of
+// the byte values of each input character, plus a suffix.
+void Tokenize(const std::string& input, std::vector<std::size_t>* lengths) {
   // Treat each character as a length.
-  std::vector<std::size_t> lengths;
-  for (char c : input)
-    lengths.push_back(c);
+  lengths->assign(input.begin(), input.end());
 
   // Add hardcoded suffix.
   constexpr std::size_t kSuffix[5] = {17, 31, 73, 47, 23};
-  lengths.insert(lengths.end(), std::begin(kSuffix), std::end(kSuffix));
-
-  return lengths;
+  lengths->insert(lengths->end(), std::begin(kSuffix), std::end(kSuffix));
 }
 
+constexpr std::size_t kListLength = 256;
+using SparseHashList = std::array<std::uint8_t, kListLength>;
+
 // Computes a "sparse hash" using |lengths|.
-std::vector<std::uint8_t> SparseHash(const std::vector<std::size_t>& lengths) {
-  // Initial vector is the series {0, 1, 2, ..., 255}.
-  constexpr std::size_t kListLength = 256;
-  std::vector<std::uint8_t> hash(kListLength);
+SparseHashList SparseHash(const std::vector<std::size_t>& lengths) {
+  // Initial list is the series {0, 1, 2, ..., 255}.
+  SparseHashList hash;
   std::iota(hash.begin(), hash.end(), 0);
 
   // Reverses the subsequence of |hash| at [pos, pos + len), treating |hash|
   // circularly.
-  const auto Reverse = [&hash, kListLength](std::size_t pos, std::size_t len) {
+  const auto Reverse = [&hash](std::size_t pos, std::size_t len) {
     // Reverse by pairwise-swapping the sequence ends, shrinking inward.
     for (std::size_t i = pos; len > 1; ++i, len -= 2)
       std::swap(hash[i % kListLength], hash[(i + len - 1) % kListLength]);
@@ -61,41 +67,229 @@ std::vector<std::uint8_t> SparseHash(const std::vector<std::size_t>& lengths) {
   return hash;
 }
 
+// A grid of used and free squares, packed one bit per square.  Each row is a
+// series of 64-bit words, with column c in bit (c % 64) of word (c / 64), so
+// adjacent columns are adjacent bits.  Bits past the last column are always 0.
+class Grid {
+ public:
+  Grid(std::size_t rows, std::size_t columns)
+      : rows_(rows),
+        columns_(columns),
+        words_per_row_((columns + 63) / 64),
+        words_(rows * words_per_row_, 0) {}
+
+  std::size_t rows() const { return rows_; }
+  std::size_t columns() const { return columns_; }
+  std::size_t words_per_row() const { return words_per_row_; }
+
+  const std::uint64_t* row(std::size_t row) const {
+    return &words_[row * words_per_row_];
+  }
+  std::uint64_t* row(std::size_t row) { return &words_[row * words_per_row_]; }
+
+  bool used(std::size_t row, std::size_t column) const {
+    return (this->row(row)[column / 64] >> (column % 64)) & 1;
+  }
+
+  bool operator==(const Grid& other) const {
+    return (rows_ == other.rows_) && (columns_ == other.columns_) &&
+           (words_ == other.words_);
+  }
+
+ private:
+  std::size_t rows_;
+  std::size_t columns_;
+  std::size_t words_per_row_;
+  std::vector<std::uint64_t> words_;
+};
+
+// The number of columns in a grid built from knot hashes.
+constexpr std::size_t kGridColumns = 128;
+
 // Computes the "knot hash" of the provided |sparse_hash| by bitwise-XORing
-// groups of 16 numbers, then concatenating the bit representations of the
-// results.
-std::vector<bool> KnotHash(const std::vector<std::uint8_t>& sparse_hash) {
-  std::vector<bool> hash;
-  for (auto i = sparse_hash.cbegin(); i != sparse_hash.cend(); ) {
-    // XOR the next (up to) 16 numbers together.
-    constexpr std::size_t kValuesToXor = 16;
-    const size_t remaining_size =
-        static_cast<std::size_t>(std::distance(i, sparse_hash.end()));
-    const auto end = std::next(i, std::min(kValuesToXor, remaining_size));
+// groups of 16 numbers, and writes its 128 bits to |row|.  The most
+// significant bit of the first number is column 0.
+void KnotHash(const SparseHashList& sparse_hash, std::uint64_t* row) {
+  row[0] = row[1] = 0;
+  for (std::size_t i = 0; i < 16; ++i) {
+    const auto begin = sparse_hash.cbegin() + i * 16;
     const std::uint8_t val =
-        std::accumulate(i, end, 0, std::bit_xor<std::uint8_t>());
-
-    // Concatenate the bits of |val| to |hash|.
-    for (std::uint8_t mask = 0x80; mask; mask >>= 1)
-      hash.push_back(!!(val & mask));
+        std::accumulate(begin, begin + 16, 0, std::bit_xor<std::uint8_t>());
 
-    i = end;
+    // Columns run from the most significant bit of |val| to the least, but
+    // from the least significant bit of the row word to the most.
+    for (std::size_t bit = 0; bit < 8; ++bit) {
+      const std::size_t column = i * 8 + bit;
+      row[column / 64] |=
+          std::uint64_t((val >> (7 - bit)) & 1) << (column % 64);
+    }
   }
-  return hash;
 }
 
-// Constructs a 128-row grid of on/off squares based on knot hashes computed
+// The number of rows in the puzzle's grid.
+constexpr std::size_t kPuzzleRows = 128;
+
+// Constructs a |rows|-row grid of on/off squares based on knot hashes computed
 // from successively-modified versions of |input|.
-std::vector<std::vector<bool>> ConstructGrid(const std::string& input) {
-  std::vector<std::vector<bool>> grid;
-  constexpr std::size_t kGridRows = 128;
-  for (std::size_t i = 0; i < kGridRows; ++i) {
-    grid.push_back(
-        KnotHash(SparseHash(Tokenize(input + "-" + std::to_string(i)))));
-  }
+//
+// The rows are independent, so they're hashed on |threads| threads (or one per
+// hardware thread if |threads| is 0).  Threads claim batches of rows from a
+// shared counter and write each row's bits straight into the grid, reusing
+// their own key and lengths buffers from row to row.
+Grid ConstructGrid(const std::string& input,
+                   std::size_t rows = kPuzzleRows,
+                   unsigned threads = 0) {
+  Grid grid(rows, kGridColumns);
+
+  constexpr std::size_t kRowsPerClaim = 16;
+  std::atomic<std::size_t> next_row(0);
+  const auto Work = [&input, rows, &grid, &next_row]() {
+    std::string key = input + "-";
+    const std::size_t prefix_size = key.size();
+    std::vector<std::size_t> lengths;
+    for (std::size_t first;
+         (first = next_row.fetch_add(kRowsPerClaim)) < rows; ) {
+      const std::size_t last = std::min(first + kRowsPerClaim, rows);
+      for (std::size_t i = first; i < last; ++i) {
+        key.resize(prefix_size);
+        key += std::to_string(i);
+        Tokenize(key, &lengths);
+        KnotHash(SparseHash(lengths), grid.row(i));
+      }
+    }
+  };
+
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  const std::size_t claims = (rows + kRowsPerClaim - 1) / kRowsPerClaim;
+  threads = static_cast<unsigned>(
+      std::max<std::size_t>(std::min<std::size_t>(threads, claims), 1));
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; ++i)
+    workers.emplace_back(Work);
+  Work();  // The calling thread is one of the workers.
+  for (auto& worker : workers)
+    worker.join();
   return grid;
 }
 
+// Returns the total number of "used squares" in |grid|.
+std::size_t CountSquares(const Grid& grid) {
+  // Since unused bits past the last column are 0, we can count whole words.
+  const std::uint64_t* const words = grid.row(0);
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < grid.rows() * grid.words_per_row(); ++i)
+    count += std::bitset<64>(words[i]).count();
+  return count;
+}
+
+// Returns the index of the lowest set bit in |word|, which must be nonzero.
+inline std::size_t LowestBit(std::uint64_t word) {
+#if defined(__GNUC__)
+  return static_cast<std::size_t>(__builtin_ctzll(word));
+#else
+  return std::bitset<64>((word & (~word + 1)) - 1).count();
+#endif
+}
+
+// A horizontal run of used squares in a row, covering columns [begin, end).
+// |label| identifies the run within CountRegions().
+struct Run {
+  std::size_t begin, end, label;
+};
+
+// Replaces |runs| with the runs of used squares in |row|, which is
+// |words| words long, in column order.
+void FindRuns(const std::uint64_t* row,
+              std::size_t words,
+              std::vector<Run>* runs) {
+  runs->clear();
+
+  // Returns the first column at or after |column| that is used (if |used| is
+  // true) or free (if false), or words * 64 if there is none.  Whole words of
+  // the wrong kind are skipped at once.
+  const std::size_t end = words * 64;
+  const auto NextColumn = [row, words, end](std::size_t column, bool used) {
+    for (std::size_t word = column / 64; word < words; ++word) {
+      std::uint64_t bits = used ? row[word] : ~row[word];
+      if (word == column / 64)
+        bits &= ~std::uint64_t(0) << (column % 64);
+      if (bits)
+        return word * 64 + LowestBit(bits);
+    }
+    return end;
+  };
+
+  for (std::size_t column = NextColumn(0, true); column < end; ) {
+    const std::size_t run_end = NextColumn(column, false);
+    runs->push_back({column, run_end, 0});
+    column = NextColumn(run_end, true);
+  }
+}
+
+// Returns the number of distinct contiguous regions of used squares in |grid|.
+//
+// Rather than flood-filling square by square, this works a row at a time on
+// runs of used squares, which are found a word at a time.  Each run starts out
+// as its own region, and runs in adjacent rows whose columns overlap are
+// merged with union-find.  Since runs within each row are in column order, the
+// overlapping runs can be found by walking both rows' runs together.
+std::size_t CountRegions(const Grid& grid) {
+  std::vector<std::size_t> parents;  // Indexed by run label.
+  const auto Find = [&parents](std::size_t label) {
+    while (parents[label] != label) {
+      parents[label] = parents[parents[label]];
+      label = parents[label];
+    }
+    return label;
+  };
+
+  std::size_t regions = 0;
+  std::vector<Run> previous, current;
+  for (std::size_t row = 0; row < grid.rows(); ++row) {
+    FindRuns(grid.row(row), grid.words_per_row(), &current);
+    for (Run& run : current) {
+      run.label = parents.size();
+      parents.push_back(run.label);
+    }
+    regions += current.size();
+
+    auto first_candidate = previous.cbegin();
+    for (const Run& run : current) {
+      // Previous-row runs that end before this run begins can't touch this or
+      // any later run.
+      while ((first_candidate != previous.cend()) &&
+             (first_candidate->end <= run.begin))
+        ++first_candidate;
+      for (auto above = first_candidate;
+           (above != previous.cend()) && (above->begin < run.end); ++above) {
+        const std::size_t a = Find(run.label), b = Find(above->label);
+        if (a != b) {
+          parents[a] = b;
+          --regions;
+        }
+      }
+    }
+    previous.swap(current);
+  }
+  return regions;
+}
+
+// Returns |grid| as a vector of rows of bools, for use with the functions
+// below.
+std::vector<std::vector<bool>> ToBoolGrid(const Grid& grid) {
+  std::vector<std::vector<bool>> bool_grid(
+      grid.rows(), std::vector<bool>(grid.columns()));
+  for (std::size_t row = 0; row < grid.rows(); ++row) {
+    for (std::size_t column = 0; column < grid.columns(); ++column)
+      bool_grid[row][column] = grid.used(row, column);
+  }
+  return bool_grid;
+}
+
+// The functions below are the original, unpacked implementations of
+// CountSquares() and CountRegions(), kept as a reference for benchmarking.
+
 // Returns the total number of "used squares" (true values) in |grid|.
 std::size_t CountSquares(const std::vector<std::vector<bool>>& grid) {
   const auto SquaresInRow = [](std::size_t count, const auto& row) {
@@ -165,17 +359,148 @@ std::size_t CountRegions(std::vector<std::vector<bool>> grid) {
 
 }  // namespace
 
+namespace day14 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  std::string key;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    key = input.substr(0, input.find('\n'));
+  }
+
+  // Constructing the grid is most of the work; both parts share it.
+  instrumentation::Phase phase(instrumentation::kSolve);
+  const Grid grid = ConstructGrid(key);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = std::to_string(CountSquares(grid));
+  if (options::WantsPart2(part))
+    answers.part2 = std::to_string(CountRegions(grid));
+  return answers;
+}
+
+// Returns a grid of |rows| x |columns| squares, each used with probability 1/2.
+Grid GenerateGrid(std::size_t rows, std::size_t columns) {
+  std::mt19937_64 generator(2017);
+  Grid grid(rows, columns);
+  for (std::size_t row = 0; row < rows; ++row) {
+    std::uint64_t* const words = grid.row(row);
+    for (std::size_t word = 0; word < grid.words_per_row(); ++word)
+      words[word] = generator();
+    if (columns % 64) {
+      words[grid.words_per_row() - 1] &=
+          (std::uint64_t(1) << (columns % 64)) - 1;
+    }
+  }
+  return grid;
+}
+
+// Times ConstructGrid() on 10,000 rows from one thread up to one per hardware
+// thread, checking each grid against the single-threaded one.
+void BenchmarkConstruction() {
+  constexpr std::size_t kRows = 10000;
+  const Grid expected = ConstructGrid("flqrgnkx", kRows, 1);
+  const unsigned max_threads =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+    Grid grid(0, 0);
+    const double seconds = benchmark::MedianSeconds(
+        [&grid, threads]() {
+          grid = ConstructGrid("flqrgnkx", kRows, threads);
+        }, 1);
+    std::cout << "ConstructGrid(), " << kRows << " rows, " << threads
+              << " threads: " << seconds * 1000 << " ms ("
+              << kRows / seconds << " rows/s)"
+              << ((grid == expected) ? "" : " (MISMATCH)") << std::endl;
+    if (threads == max_threads)
+      break;
+  }
+}
+
+// Times the packed CountSquares() and CountRegions() against the unpacked
+// versions, on the grid for the puzzle's example input and on larger random
+// grids.
+void RunBenchmarks() {
+  const auto Benchmark = [](const char* name, const Grid& grid) {
+    const std::vector<std::vector<bool>> bool_grid = ToBoolGrid(grid);
+    const int runs = (grid.rows() > 1000) ? 1 : 5;
+    std::size_t squares = 0, regions = 0, bool_squares = 0, bool_regions = 0;
+    const double seconds = benchmark::MedianSeconds(
+        [&grid, &squares, &regions]() {
+          squares = CountSquares(grid);
+          regions = CountRegions(grid);
+        }, runs);
+    const double bool_seconds = benchmark::MedianSeconds(
+        [&bool_grid, &bool_squares, &bool_regions]() {
+          bool_squares = CountSquares(bool_grid);
+          bool_regions = CountRegions(bool_grid);
+        }, runs);
+    const bool matches = (squares == bool_squares) && (regions == bool_regions);
+    std::cout << name << " (" << grid.rows() << "x" << grid.columns() << "): "
+              << squares << " squares, " << regions << " regions; packed "
+              << seconds * 1000 << " ms, vector<bool> " << bool_seconds * 1000
+              << " ms" << (matches ? "" : " (MISMATCH)") << std::endl;
+  };
+  Benchmark("Example \"flqrgnkx\"", ConstructGrid("flqrgnkx"));
+  Benchmark("Random", GenerateGrid(1024, 1024));
+  Benchmark("Random", GenerateGrid(4096, 4096));
+
+  BenchmarkConstruction();
+}
+
+// Times ConstructGrid(), CountSquares() and CountRegions() on grids of 128
+// rows, the puzzle's size, times each scale, from a random eight-letter key.
+void RunSuite(benchmark::Suite* suite) {
+  std::mt19937 generator(2017);
+  std::string key;
+  for (int i = 0; i < 8; ++i)
+    key += static_cast<char>('a' + generator() % 26);
+  for (std::size_t scale : suite->Scales(100)) {
+    const std::size_t rows = kPuzzleRows * scale;
+    suite->Run("ConstructGrid()", scale, rows, "rows",
+               [&key, rows]() {
+      return ConstructGrid(key, benchmark::HideInput(rows));
+    });
+    const Grid grid = ConstructGrid(key, rows);
+    suite->Run("CountSquares()", scale, rows, "rows",
+               [&grid]() { return CountSquares(grid); });
+    suite->Run("CountRegions()", scale, rows, "rows",
+               [&grid]() { return CountRegions(grid); });
+  }
+}
+
+}  // namespace day14
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day14::RunBenchmarks();
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter input string: ";
 
   std::string input;
-  std::getline(std::cin, input);
-  const std::vector<std::vector<bool>> grid = ConstructGrid(input);
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::getline(std::cin, input);
+  }
 
-  if (kPart1)
-    std::cout << "Squares used: " << CountSquares(grid) << std::endl;
-  else
-    std::cout << "Regions: " << CountRegions(grid) << std::endl;
+  const solver::Answers answers = day14::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Squares used: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Regions: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(14);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
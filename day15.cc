@@ -1,56 +1,394 @@
 // Advent of Code 2017 day 15 solution
 // Peter Kasting, Dec. 15, 2017
 
+#include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <numeric>
+#include <random>
 #include <regex>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
-namespace {
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
-// Reads a line of input and converts the first number in it to a uint64_t.
-std::uint64_t GetStartingValue() {
-  std::string input;
-  std::getline(std::cin, input);
+// Converts the first number in |line| to a uint64_t.
+std::uint64_t GetStartingValue(const std::string& line) {
   std::smatch match;
   const std::regex regex("\\d+");
-  std::regex_search(input, match, regex);
+  std::regex_search(line, match, regex);
   return std::stoi(match.str());
 }
 
+// The factors and multiples for the generators, hardcoded from the problem
+// specification.
+constexpr std::uint64_t kFactorA = 16807;
+constexpr std::uint64_t kMultipleA = 4;
+constexpr std::uint64_t kFactorB = 48271;
+constexpr std::uint64_t kMultipleB = 8;
+
+// Generators produce values modulo this Mersenne prime, 2^31 - 1.
+constexpr std::uint64_t kModulus = 0x7fffffff;
+
+// Returns (|a| * |b|) % kModulus, for |a| and |b| less than kModulus.  Since
+// 2^31 = 1 (mod kModulus), the bits of the product above bit 30 can be added
+// onto the low 31 bits instead of dividing.  The sum is less than
+// 2 * kModulus, so one conditional subtract finishes the reduction.
+inline std::uint64_t MultiplyMod(std::uint64_t a, std::uint64_t b) {
+  const std::uint64_t product = a * b;
+  const std::uint64_t sum = (product & kModulus) + (product >> 31);
+  return (sum >= kModulus) ? (sum - kModulus) : sum;
+}
+
+// Returns (|base| ^ |exponent|) % kModulus, for |base| less than kModulus.
+std::uint64_t PowerMod(std::uint64_t base, std::uint64_t exponent) {
+  std::uint64_t result = 1;
+  for (; exponent; exponent >>= 1) {
+    if (exponent & 1)
+      result = MultiplyMod(result, base);
+    base = MultiplyMod(base, base);
+  }
+  return result;
+}
+
+#if defined(__AVX2__)
+// MultiplyMod() on four lanes at once.  _mm256_mul_epu32() multiplies the low
+// 32 bits of each lane, which is all of both operands.
+inline __m256i MultiplyMod(__m256i a, __m256i b) {
+  const __m256i modulus = _mm256_set1_epi64x(kModulus);
+  const __m256i product = _mm256_mul_epu32(a, b);
+  const __m256i sum = _mm256_add_epi64(_mm256_and_si256(product, modulus),
+                                       _mm256_srli_epi64(product, 31));
+  const __m256i over =
+      _mm256_cmpgt_epi64(sum, _mm256_set1_epi64x(kModulus - 1));
+  return _mm256_sub_epi64(sum, _mm256_and_si256(over, modulus));
+}
+
+// The number of consecutive generator values computed at once with AVX2.
+constexpr std::uint64_t kLanes = 8;
+#endif
+
 // Given a generator with factor |factor|, updates the starting |val| to the
 // next non-ignored value.  In part 1, no values are ignored; in part 2, values
 // not a multiple of |multiple| are ignored.
 void Generate(std::uint64_t factor,
               std::uint64_t multiple,
+              bool part1,
               std::uint64_t* val) {
-  constexpr std::uint64_t kDivisor = 0x7fffffff;
   do
-    *val = (*val * factor) % kDivisor;
-  while (!kPart1 && (*val % multiple));
-}
-
-// Returns the number of matches in a sample of generator runs with starting
-// values |a| and |b|.  The sample size in part 1 is 40,000,000; in part 2 it is
-// 5,000,000.  The factors and multiples for the generators are hardcoded from
-// the problem specification.  Output values are considered to match when their
-// least significant 16 bits are equal.
-std::size_t CountMatches(std::uint64_t a, std::uint64_t b) {
-  std::size_t count = 0;
-  constexpr std::size_t kSampleSize = kPart1 ? 40000000 : 5000000;
-  for (std::size_t i = 0; i < kSampleSize; ++i) {
-    // Update generators A and B to their next values.
-    constexpr std::uint64_t kFactorA = 16807;
-    constexpr std::uint64_t kMultipleA = 4;
+    *val = MultiplyMod(*val, factor);
+  while (!part1 && (*val % multiple));
+}
+
+// Returns the number of matches in |samples| steps of the part 1 generators,
+// starting from values |a| and |b|.  Output values are considered to match
+// when their least significant 16 bits are equal.
+std::uint64_t CountUnfilteredMatches(std::uint64_t a,
+                                     std::uint64_t b,
+                                     std::uint64_t samples) {
+  std::uint64_t count = 0;
+#if defined(__AVX2__)
+  // Each generator's next kLanes values are held in two vectors, with lane i
+  // holding the value i + 1 steps ahead.  Multiplying every lane by
+  // factor^kLanes then advances the whole batch kLanes steps at once.  The two
+  // vectors per generator are independent, which hides the multiply latency.
+  if (samples >= kLanes) {
+    alignas(32) std::uint64_t values_a[kLanes], values_b[kLanes];
+    for (std::uint64_t i = 0; i < kLanes; ++i) {
+      values_a[i] = a = MultiplyMod(a, kFactorA);
+      values_b[i] = b = MultiplyMod(b, kFactorB);
+    }
+    const auto Load = [](const std::uint64_t* values) {
+      return _mm256_load_si256(reinterpret_cast<const __m256i*>(values));
+    };
+    __m256i a0 = Load(values_a), a1 = Load(values_a + 4);
+    __m256i b0 = Load(values_b), b1 = Load(values_b + 4);
+
+    // Matching lanes compare to all ones, i.e. -1, so subtracting the
+    // comparison results counts matches per lane.
+    const __m256i low_bits = _mm256_set1_epi64x(0xffff);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i counts = zero;
+    const auto Count = [&low_bits, &zero, &counts](__m256i a, __m256i b) {
+      const __m256i diff = _mm256_and_si256(_mm256_xor_si256(a, b), low_bits);
+      counts = _mm256_sub_epi64(counts, _mm256_cmpeq_epi64(diff, zero));
+    };
+
+    const __m256i jump_a = _mm256_set1_epi64x(PowerMod(kFactorA, kLanes));
+    const __m256i jump_b = _mm256_set1_epi64x(PowerMod(kFactorB, kLanes));
+    Count(a0, b0);
+    Count(a1, b1);
+    std::uint64_t done = kLanes;
+    for (; samples - done >= kLanes; done += kLanes) {
+      a0 = MultiplyMod(a0, jump_a);
+      a1 = MultiplyMod(a1, jump_a);
+      b0 = MultiplyMod(b0, jump_b);
+      b1 = MultiplyMod(b1, jump_b);
+      Count(a0, b0);
+      Count(a1, b1);
+    }
+
+    alignas(32) std::uint64_t lane_counts[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_counts), counts);
+    count = lane_counts[0] + lane_counts[1] + lane_counts[2] + lane_counts[3];
+
+    // Finish any remaining samples below, starting from the last lane.
+    a = static_cast<std::uint64_t>(_mm256_extract_epi64(a1, 3));
+    b = static_cast<std::uint64_t>(_mm256_extract_epi64(b1, 3));
+    samples -= done;
+  }
+#endif
+
+  for (; samples; --samples) {
+    a = MultiplyMod(a, kFactorA);
+    b = MultiplyMod(b, kFactorB);
+    count += !((a ^ b) & 0xffff);
+  }
+  return count;
+}
+
+// Like CountUnfilteredMatches(), but for the part 2 generators, which skip
+// values that aren't multiples of kMultipleA and kMultipleB respectively.
+// This runs the generators in lockstep, so each sample waits on both
+// generators' rejection loops; it's kept as a reference for benchmarking
+// CountFilteredMatches().
+std::uint64_t LockstepCountFilteredMatches(std::uint64_t a,
+                                           std::uint64_t b,
+                                           std::uint64_t samples) {
+  std::uint64_t count = 0;
+  for (; samples; --samples) {
+    Generate(kFactorA, kMultipleA, false, &a);
+    Generate(kFactorB, kMultipleB, false, &b);
+    count += !((a ^ b) & 0xffff);
+  }
+  return count;
+}
+
+// Advances the generator with factor |factor| from |*val|, writing the low 16
+// bits of the next |count| values that are multiples of |multiple| (a power of
+// two) to |output|, and leaves |*val| at the last of those values.  Every
+// value is written to the output, but the output position only advances past
+// accepted ones, so no branch depends on whether a value is accepted.
+void FillAccepted(std::uint64_t factor,
+                  std::uint64_t multiple,
+                  std::uint64_t* val,
+                  std::uint16_t* output,
+                  std::size_t count) {
+  if (!count)
+    return;
+  const std::uint64_t mask = multiple - 1;
+  std::uint64_t value = *val;
+  std::size_t accepted = 0;
+#if defined(__AVX2__)
+  // As in CountUnfilteredMatches(), compute kLanes consecutive values at a
+  // time, then filter them one by one.
+  alignas(32) std::uint64_t values[kLanes];
+  for (std::uint64_t i = 0; i < kLanes; ++i)
+    values[i] = value = MultiplyMod(value, factor);
+  __m256i values0 = _mm256_load_si256(reinterpret_cast<__m256i*>(values));
+  __m256i values1 = _mm256_load_si256(reinterpret_cast<__m256i*>(values + 4));
+  const __m256i jump = _mm256_set1_epi64x(PowerMod(factor, kLanes));
+  while (true) {
+    for (std::uint64_t i = 0; (i < kLanes) && (accepted < count); ++i) {
+      value = values[i];
+      output[accepted] = static_cast<std::uint16_t>(value);
+      accepted += !(value & mask);
+    }
+    if (accepted == count)
+      break;
+    values0 = MultiplyMod(values0, jump);
+    values1 = MultiplyMod(values1, jump);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(values), values0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(values + 4), values1);
+  }
+#else
+  while (accepted < count) {
+    value = MultiplyMod(value, factor);
+    output[accepted] = static_cast<std::uint16_t>(value);
+    accepted += !(value & mask);
+  }
+#endif
+  *val = value;
+}
+
+// Returns the number of indices below |size| where |a| and |b| are equal.
+std::size_t CountEqual(const std::uint16_t* a,
+                       const std::uint16_t* b,
+                       std::size_t size) {
+  std::size_t count = 0, i = 0;
+#if defined(__SSE2__)
+  // Compare eight values at a time.  Each equal value sets two bits of the
+  // byte mask, so the total is halved at the end.
+  for (; i + 8 <= size; i += 8) {
+    const __m128i equal = _mm_cmpeq_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+    count += std::bitset<16>(_mm_movemask_epi8(equal)).count();
+  }
+  count /= 2;
+#endif
+  for (; i < size; ++i)
+    count += a[i] == b[i];
+  return count;
+}
+
+// Like LockstepCountFilteredMatches(), but decouples the generators.  Each
+// generator fills blocks of accepted values at its own pace with
+// FillAccepted(), and the blocks are compared with CountEqual().
+//
+// With |threads| of 1, the blocks are filled and compared in turn.  Otherwise
+// (and by default, if there is more than one hardware thread), each generator
+// runs on its own thread, filling a ring of kSlots blocks ahead of the calling
+// thread, which compares each block once both generators have finished it.
+std::uint64_t CountFilteredMatches(std::uint64_t a,
+                                   std::uint64_t b,
+                                   std::uint64_t samples,
+                                   unsigned threads = 0) {
+  constexpr std::size_t kBlockSize = 1 << 14;
+  constexpr std::size_t kSlots = 8;
+  const std::uint64_t blocks = (samples + kBlockSize - 1) / kBlockSize;
+  const auto BlockSize = [samples](std::uint64_t block) {
+    return static_cast<std::size_t>(
+        std::min(std::uint64_t(kBlockSize), samples - block * kBlockSize));
+  };
+  std::vector<std::uint16_t> outputs_a(kSlots * kBlockSize);
+  std::vector<std::uint16_t> outputs_b(kSlots * kBlockSize);
+  const auto Slot = [](std::vector<std::uint16_t>* outputs,
+                       std::uint64_t block) {
+    return &(*outputs)[block % kSlots * kBlockSize];
+  };
+
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  std::uint64_t count = 0;
+  if (threads == 1) {
+    for (std::uint64_t block = 0; block < blocks; ++block) {
+      const std::size_t size = BlockSize(block);
+      FillAccepted(kFactorA, kMultipleA, &a, outputs_a.data(), size);
+      FillAccepted(kFactorB, kMultipleB, &b, outputs_b.data(), size);
+      count += CountEqual(outputs_a.data(), outputs_b.data(), size);
+    }
+    return count;
+  }
+
+  // |produced_a| and |produced_b| count the blocks each generator has
+  // finished, and |consumed| counts the blocks compared, whose slots the
+  // generators may then reuse.
+  std::atomic<std::uint64_t> produced_a(0), produced_b(0), consumed(0);
+  const auto Produce = [blocks, &BlockSize, &Slot, &consumed](
+                           std::uint64_t factor, std::uint64_t multiple,
+                           std::uint64_t val,
+                           std::vector<std::uint16_t>* outputs,
+                           std::atomic<std::uint64_t>* produced) {
+    for (std::uint64_t block = 0; block < blocks; ++block) {
+      while (block >= consumed.load(std::memory_order_acquire) + kSlots)
+        std::this_thread::yield();
+      FillAccepted(factor, multiple, &val, Slot(outputs, block),
+                   BlockSize(block));
+      produced->store(block + 1, std::memory_order_release);
+    }
+  };
+  std::thread producer_a(Produce, kFactorA, kMultipleA, a, &outputs_a,
+                         &produced_a);
+  std::thread producer_b(Produce, kFactorB, kMultipleB, b, &outputs_b,
+                         &produced_b);
+  for (std::uint64_t block = 0; block < blocks; ++block) {
+    while ((block >= produced_a.load(std::memory_order_acquire)) ||
+           (block >= produced_b.load(std::memory_order_acquire)))
+      std::this_thread::yield();
+    count += CountEqual(Slot(&outputs_a, block), Slot(&outputs_b, block),
+                        BlockSize(block));
+    consumed.store(block + 1, std::memory_order_release);
+  }
+  producer_a.join();
+  producer_b.join();
+  return count;
+}
+
+// Like CountUnfilteredMatches(), but splits the samples into equal slices
+// across |threads| threads (or one per hardware thread if |threads| is 0).
+// Since each generator is a plain multiplicative generator, its value n steps
+// after |val| is (val * factor^n) % kModulus, so each thread can jump straight
+// to the start of its slice in O(log n) time.
+std::uint64_t ParallelCountUnfilteredMatches(std::uint64_t a,
+                                             std::uint64_t b,
+                                             std::uint64_t samples,
+                                             unsigned threads = 0) {
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  const auto Bound = [samples, threads](unsigned i) {
+    return samples / threads * i +
+           std::min<std::uint64_t>(i, samples % threads);
+  };
+
+  std::vector<std::uint64_t> counts(threads);
+  const auto Work = [a, b, &Bound, &counts](unsigned i) {
+    const std::uint64_t begin = Bound(i);
+    counts[i] = CountUnfilteredMatches(
+        MultiplyMod(a, PowerMod(kFactorA, begin)),
+        MultiplyMod(b, PowerMod(kFactorB, begin)), Bound(i + 1) - begin);
+  };
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; ++i)
+    workers.emplace_back(Work, i);
+  Work(0);  // The calling thread takes the first slice.
+  for (auto& worker : workers)
+    worker.join();
+  return std::accumulate(counts.begin(), counts.end(), std::uint64_t(0));
+}
+
+// Returns the number of matches in |samples| generator runs with starting
+// values |a| and |b|.
+std::uint64_t CountMatches(std::uint64_t a,
+                           std::uint64_t b,
+                           bool part1,
+                           std::uint64_t samples) {
+  return part1 ? ParallelCountUnfilteredMatches(a, b, samples)
+               : CountFilteredMatches(a, b, samples);
+}
+
+// Like above, using the puzzle's sample size, which in part 1 is 40,000,000
+// and in part 2 is 5,000,000.
+std::uint64_t CountMatches(std::uint64_t a,
+                           std::uint64_t b,
+                           bool part1) {
+  return CountMatches(a, b, part1, part1 ? 40000000 : 5000000);
+}
+
+// The original CountMatches(), which reduces each generator value with a
+// 64-bit division, kept as a reference for benchmarking.
+std::uint64_t CountMatchesWithDivide(std::uint64_t a,
+                                     std::uint64_t b,
+                                     bool part1) {
+  const auto Generate = [part1](std::uint64_t factor, std::uint64_t multiple,
+                                std::uint64_t* val) {
+    constexpr std::uint64_t kDivisor = 0x7fffffff;
+    do
+      *val = (*val * factor) % kDivisor;
+    while (!part1 && (*val % multiple));
+  };
+
+  std::uint64_t count = 0;
+  const std::size_t sample_size = part1 ? 40000000 : 5000000;
+  for (std::size_t i = 0; i < sample_size; ++i) {
     Generate(kFactorA, kMultipleA, &a);
-    constexpr std::uint64_t kFactorB = 48271;
-    constexpr std::uint64_t kMultipleB = 8;
     Generate(kFactorB, kMultipleB, &b);
-
-    // See if the bottom 16 bits match.
     if ((a & 0xffff) == (b & 0xffff))
       ++count;
   }
@@ -59,15 +397,164 @@ std::size_t CountMatches(std::uint64_t a, std::uint64_t b) {
 
 }  // namespace
 
+namespace day15 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  std::uint64_t a, b;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    // Each generator's starting value is on its own line.
+    std::istringstream stream(input);
+    std::string line_a, line_b;
+    std::getline(stream, line_a);
+    std::getline(stream, line_b);
+    a = GetStartingValue(line_a);
+    b = GetStartingValue(line_b);
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = std::to_string(CountMatches(a, b, true));
+  if (options::WantsPart2(part))
+    answers.part2 = std::to_string(CountMatches(a, b, false));
+  return answers;
+}
+
+// Times CountMatches() against CountMatchesWithDivide() for both parts, using
+// the starting values from the puzzle's example.
+void RunBenchmarks() {
+  volatile std::uint64_t start_a = 65, start_b = 8921;
+  for (bool part1 : {true, false}) {
+    volatile std::uint64_t count = 0, reference_count = 0;
+    const double seconds =
+        benchmark::MedianSeconds([&start_a, &start_b, part1, &count]() {
+          count = CountMatches(start_a, start_b, part1);
+        });
+    const double reference_seconds = benchmark::MedianSeconds(
+        [&start_a, &start_b, part1, &reference_count]() {
+          reference_count = CountMatchesWithDivide(start_a, start_b, part1);
+        });
+    std::cout << "Part " << (part1 ? 1 : 2) << ": " << count
+              << " matches; CountMatches() " << seconds * 1000
+              << " ms, with divide " << reference_seconds * 1000 << " ms ("
+              << reference_seconds / seconds << "x)"
+              << ((count == reference_count) ? "" : " (MISMATCH)")
+              << std::endl;
+  }
+
+  // Check ParallelCountUnfilteredMatches() against the serial count for
+  // various thread counts, including ones that don't divide the samples
+  // evenly, then time it on a much larger sample.
+  const std::uint64_t expected = CountUnfilteredMatches(start_a, start_b,
+                                                        40000000);
+  const unsigned max_threads =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<unsigned> thread_counts = {1, 3, 7};
+  if (std::find(thread_counts.begin(), thread_counts.end(), max_threads) ==
+      thread_counts.end())
+    thread_counts.push_back(max_threads);
+  for (unsigned threads : thread_counts) {
+    volatile std::uint64_t count = 0;
+    const double seconds = benchmark::MedianSeconds(
+        [&start_a, &start_b, threads, &count]() {
+          count = ParallelCountUnfilteredMatches(start_a, start_b, 40000000,
+                                                 threads);
+        });
+    std::cout << "Part 1, " << threads << " threads: " << count
+              << " matches in " << seconds * 1000 << " ms"
+              << ((count == expected) ? "" : " (MISMATCH)") << std::endl;
+  }
+  constexpr std::uint64_t kLargeSamples = 1000000000;
+  volatile std::uint64_t count = 0;
+  const double seconds =
+      benchmark::MedianSeconds([&start_a, &start_b, &count]() {
+        count = ParallelCountUnfilteredMatches(start_a, start_b,
+                                               kLargeSamples);
+      }, 1);
+  std::cout << "Part 1, " << kLargeSamples << " samples: " << count
+            << " matches in " << seconds << " s (" << kLargeSamples / seconds
+            << " samples/s)" << std::endl;
+
+  // Time CountFilteredMatches(), both decoupled on one thread and pipelined
+  // across generator threads, against the lockstep loop.
+  volatile std::uint64_t lockstep_count = 0;
+  const double lockstep_seconds =
+      benchmark::MedianSeconds([&start_a, &start_b, &lockstep_count]() {
+        lockstep_count =
+            LockstepCountFilteredMatches(start_a, start_b, 5000000);
+      });
+  std::cout << "Part 2, lockstep: " << lockstep_count << " matches in "
+            << lockstep_seconds * 1000 << " ms" << std::endl;
+  for (unsigned threads : {1u, 2u}) {
+    volatile std::uint64_t filtered_count = 0;
+    const double filtered_seconds = benchmark::MedianSeconds(
+        [&start_a, &start_b, threads, &filtered_count]() {
+          filtered_count =
+              CountFilteredMatches(start_a, start_b, 5000000, threads);
+        });
+    std::cout << "Part 2, " << ((threads == 1) ? "decoupled" : "pipelined")
+              << ": " << filtered_count << " matches in "
+              << filtered_seconds * 1000 << " ms ("
+              << lockstep_seconds / filtered_seconds << "x)"
+              << ((filtered_count == lockstep_count) ? "" : " (MISMATCH)")
+              << std::endl;
+  }
+}
+
+// Times CountMatches() for each part on the puzzle's sample counts times each
+// scale, from random starting values.
+void RunSuite(benchmark::Suite* suite) {
+  std::mt19937 generator(2017);
+  const std::uint64_t a = 1 + generator() % (kModulus - 1);
+  const std::uint64_t b = 1 + generator() % (kModulus - 1);
+  for (std::size_t scale : suite->Scales(10)) {
+    for (bool part1 : {true, false}) {
+      const std::uint64_t samples = (part1 ? 40000000 : 5000000) * scale;
+      suite->Run(part1 ? "CountMatches(), part 1" : "CountMatches(), part 2",
+                 scale, static_cast<double>(samples), "samples",
+                 [a, b, part1, samples]() {
+        return CountMatches(benchmark::HideInput(a), benchmark::HideInput(b),
+                            benchmark::HideInput(part1),
+                            benchmark::HideInput(samples));
+      });
+    }
+  }
+}
+
+}  // namespace day15
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day15::RunBenchmarks();
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter starting values." << std::endl;
 
-  // Note: Inlining these calls into the statement below is dangerous because
-  // the order of evaluation of the parameters to CountMatches() is undefined.
-  const std::uint64_t a = GetStartingValue();
-  const std::uint64_t b = GetStartingValue();
+  std::string line_a, line_b;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::getline(std::cin, line_a);
+    std::getline(std::cin, line_b);
+  }
 
-  std::cout << "Judge's count: " << CountMatches(a, b) << std::endl;
+  const solver::Answers answers = day15::Solve(line_a + '\n' + line_b, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Judge's count: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Judge's count: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(15);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
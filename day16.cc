@@ -1,22 +1,43 @@
 // Advent of Code 2017 day 16 solution
 // Peter Kasting, Dec. 17, 2017
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "numbers.h"
+#include "options.h"
+#include "solver.h"
+
 namespace {
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
 constexpr std::size_t kNumPrograms = 16;  // How many programs are dancing.
 
-// Returns the string "abc...", with kNumPrograms total characters.
-std::string GeneratePrograms() {
-  std::string programs(kNumPrograms, 'a');
+// How many times the programs dance in each part.
+constexpr std::uint64_t kPart1Dances = 1;
+constexpr std::uint64_t kPart2Dances = 1000000000;
+
+// Returns the string "abc...", with |count| total characters.
+std::string GeneratePrograms(std::size_t count = kNumPrograms) {
+  std::string programs(count, 'a');
   std::iota(programs.begin() + 1, programs.end(), 'b');
   return programs;
 }
@@ -74,7 +95,9 @@ template<typename T> inline T ToT(char name);
 
 template<>
 inline std::size_t ToT(char name) {
-  return static_cast<std::size_t>(name - 'a');
+  // Names past 'z' wrap around modulo 256, which keeps them distinct for up to
+  // 256 programs.
+  return static_cast<std::uint8_t>(name - 'a');
 }
 
 template<>
@@ -82,6 +105,113 @@ inline char ToT(char name) {
   return name;
 }
 
+// A dance move compiled from its text form.  Spins store the spin size in |a|;
+// exchanges store the two positions in |a| and |b|; partner moves store the two
+// names, as numbers (see ToT()), in |a| and |b|.
+struct Move {
+  enum class Op : std::uint8_t { kSpin, kExchange, kPartner };
+  Op op;
+  std::uint8_t a, b;
+};
+
+// Compiles the comma-separated moves in |input|, for a dance of |count|
+// programs, into Moves, without copying out any substrings.  Throws
+// std::invalid_argument if a spin is longer than |count| or an exchange or
+// partner move names a position or program past the last.
+std::vector<Move> CompileMoves(std::string_view input,
+                               std::size_t count = kNumPrograms) {
+  std::vector<Move> moves;
+  // Returns |operand| as a byte, after checking that it's at most |max|.
+  const auto Operand = [count](std::size_t operand, std::size_t max) {
+    if (operand > max) {
+      throw std::invalid_argument("Move operand " + std::to_string(operand) +
+                                  " is out of range for " +
+                                  std::to_string(count) + " programs");
+    }
+    return static_cast<std::uint8_t>(operand);
+  };
+  const auto Number = [&input, &Operand](std::size_t max) {
+    unsigned number = 0;
+    numbers::NextNumber(&input, &number);
+    return Operand(number, max);
+  };
+  while (!input.empty()) {
+    const char op = input.front();
+    input.remove_prefix(1);
+    switch (op) {
+      case 's':
+        moves.push_back({Move::Op::kSpin, Number(count), 0});
+        break;
+      case 'x': {
+        const std::uint8_t a = Number(count - 1);
+        moves.push_back({Move::Op::kExchange, a, Number(count - 1)});
+        break;
+      }
+      case 'p':
+        if (input.size() >= 3) {
+          moves.push_back({Move::Op::kPartner,
+                           Operand(ToT<std::size_t>(input[0]), count - 1),
+                           Operand(ToT<std::size_t>(input[2]), count - 1)});
+          input.remove_prefix(3);
+        }
+        break;
+      default:
+        // Separators and whitespace.
+        break;
+    }
+  }
+  return moves;
+}
+
+// Updates |position_transform| and |name_transform| to reflect applying
+// |moves|, with the same result as calling ParseMove() on each move.
+//
+// The position transform is kept in a ring with a moving start offset, so a
+// spin just moves the offset instead of rotating anything.  Alongside the name
+// transform, which maps each original name to its current one, is its inverse,
+// so a partner move can find both programs without searching.
+void ExecuteMoves(const std::vector<Move>& moves,
+                  std::string* position_transform,
+                  std::string* name_transform) {
+  const std::size_t count = position_transform->size();
+  std::vector<std::uint8_t> positions(count), names(count), originals(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    positions[i] = static_cast<std::uint8_t>(
+        ToT<std::size_t>((*position_transform)[i]));
+    names[i] =
+        static_cast<std::uint8_t>(ToT<std::size_t>((*name_transform)[i]));
+    originals[names[i]] = static_cast<std::uint8_t>(i);
+  }
+
+  // Position i is at positions[(offset + i) % count].
+  std::size_t offset = 0;
+  const auto Slot = [count, &offset](std::size_t position) {
+    position += offset;
+    return (position >= count) ? (position - count) : position;
+  };
+  for (const Move& move : moves) {
+    switch (move.op) {
+      case Move::Op::kSpin:
+        // The last |a| programs become the first, so position 0 is now what
+        // was position count - a.
+        offset = Slot(count - move.a);
+        break;
+      case Move::Op::kExchange:
+        std::swap(positions[Slot(move.a)], positions[Slot(move.b)]);
+        break;
+      case Move::Op::kPartner:
+        std::swap(names[originals[move.a]], names[originals[move.b]]);
+        std::swap(originals[move.a], originals[move.b]);
+        break;
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    (*position_transform)[i] = ToT<char>(std::size_t(positions[Slot(i)]));
+    (*name_transform)[i] = ToT<char>(std::size_t(names[i]));
+  }
+}
+
 // Returns the next unvisited position after |start|, given |visited| tracks
 // whether each position has been visited.
 std::size_t FindNextUnvisited(const std::vector<bool>& visited,
@@ -129,8 +259,8 @@ std::map<T, T> FindCycle(const std::string& transform,
 template<typename T>
 std::vector<std::map<T, T>> FindCycles(const std::string& transform) {
   std::vector<std::map<T, T>> cycles;
-  std::vector<bool> visited(kNumPrograms, false);
-  for (std::size_t start_pos = 0; start_pos != kNumPrograms; )
+  std::vector<bool> visited(transform.size(), false);
+  for (std::size_t start_pos = 0; start_pos != transform.size(); )
     cycles.push_back(FindCycle<T>(transform, &start_pos, &visited));
   return cycles;
 }
@@ -181,33 +311,448 @@ void ApplyCycles(const std::vector<std::map<T, T>>& cycles,
 }
 
 // Returns the transformed program string that results from applying
-// |position_transform| and |name_transform| a number of times.  In part 1, this
-// number is 1; in part 2, it's 1,000,000,000.
-std::string TransformedPrograms(const std::string& position_transform,
-                                const std::string& name_transform) {
-  constexpr std::size_t kNumDances = kPart1 ? 1 : 1000000000;
-  std::string programs = GeneratePrograms();
+// |position_transform| and |name_transform| |dances| times, by applying each
+// of their cycles directly.  This is the original implementation of
+// TransformedPrograms(), kept as a reference for benchmarking.
+std::string CycleTransformedPrograms(const std::string& position_transform,
+                                     const std::string& name_transform,
+                                     std::uint64_t dances) {
+  std::string programs = GeneratePrograms(position_transform.size());
   ApplyCycles<std::size_t>(FindCycles<std::size_t>(position_transform),
-                           kNumDances, &programs);
-  ApplyCycles<char>(FindCycles<char>(name_transform), kNumDances, &programs);
+                           dances, &programs);
+  ApplyCycles<char>(FindCycles<char>(name_transform), dances, &programs);
   return programs;
 }
 
+// A permutation of N programs (N <= 256), as the position or name each
+// program's new position or name comes from; i.e. the transforms above, as
+// numbers instead of names.
+template<std::size_t N>
+using Permutation = std::array<std::uint8_t, N>;
+
+// Returns |transform| as a Permutation.
+template<std::size_t N>
+Permutation<N> ToPermutation(const std::string& transform) {
+  Permutation<N> permutation;
+  for (std::size_t i = 0; i < N; ++i)
+    permutation[i] = static_cast<std::uint8_t>(ToT<std::size_t>(transform[i]));
+  return permutation;
+}
+
+// Returns the permutation whose element i is |a|[|b|[i]].  For position
+// permutations this is |a| followed by |b|; for name permutations, |b|
+// followed by |a|.
+template<std::size_t N>
+Permutation<N> Compose(const Permutation<N>& a, const Permutation<N>& b) {
+  Permutation<N> result;
+#if defined(__SSSE3__)
+  if constexpr (N == 16) {
+    // A single byte shuffle does all 16 lookups at once.
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(result.data()),
+        _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data())),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data()))));
+    return result;
+  }
+#endif
+  for (std::size_t i = 0; i < N; ++i)
+    result[i] = a[b[i]];
+  return result;
+}
+
+// Returns |permutation| applied |times| times, using O(log |times|)
+// compositions by repeatedly squaring.
+template<std::size_t N>
+Permutation<N> Power(Permutation<N> permutation, std::uint64_t times) {
+  Permutation<N> result;
+  std::iota(result.begin(), result.end(), 0);
+  for (; times; times >>= 1) {
+    if (times & 1)
+      result = Compose(result, permutation);
+    permutation = Compose(permutation, permutation);
+  }
+  return result;
+}
+
+// Returns the transformed program string that results from applying
+// |position_transform| and |name_transform|, each N programs long, |dances|
+// times.  In part 1, |dances| is 1; in part 2, it's 1,000,000,000.
+template<std::size_t N = kNumPrograms>
+std::string TransformedPrograms(const std::string& position_transform,
+                                const std::string& name_transform,
+                                std::uint64_t dances = kPart2Dances) {
+  // Position i ends up holding the program originally at position
+  // positions[i], which is then renamed to names[positions[i]].
+  const Permutation<N> positions =
+      Power(ToPermutation<N>(position_transform), dances);
+  const Permutation<N> names = Power(ToPermutation<N>(name_transform), dances);
+  const Permutation<N> programs = Compose(names, positions);
+
+  std::string output(N, ' ');
+  for (std::size_t i = 0; i < N; ++i)
+    output[i] = ToT<char>(std::size_t(programs[i]));
+  return output;
+}
+
+// Answers queries for the lineup after various numbers of dances, for any
+// number of programs up to 256.  The position and name transforms are each
+// split into cycles once, up front, and stored flat: each cycle's elements in
+// order, one cycle after another.  A transform applied k times moves each
+// element k steps along its cycle, so a query takes one division per cycle to
+// find how far each cycle turns, then O(1) per program.
+class DanceQueries {
+ public:
+  DanceQueries(const std::string& position_transform,
+               const std::string& name_transform)
+      : positions_(position_transform), names_(name_transform) {}
+
+  std::size_t programs() const { return positions_.order.size(); }
+
+  // Returns the lineup after |dances| dances.
+  std::string Lineup(std::uint64_t dances) const {
+    std::vector<std::uint8_t> positions, names;
+    std::string lineup(programs(), ' ');
+    Lineup(dances, &positions, &names, &lineup[0]);
+    return lineup;
+  }
+
+  // Writes the lineup after each number of dances in |dances| to |lineups|,
+  // one after another, programs() characters apiece.
+  void Lineups(const std::vector<std::uint64_t>& dances, char* lineups) const {
+    std::vector<std::uint8_t> positions, names;
+    for (std::uint64_t count : dances) {
+      Lineup(count, &positions, &names, lineups);
+      lineups += programs();
+    }
+  }
+
+ private:
+  // A transform's cycles.  Cycle c is order[starts[c]] to
+  // order[starts[c + 1] - 1], where each element's successor is the transform
+  // of that element, wrapping from the end of the cycle to its start.
+  struct Cycles {
+    explicit Cycles(const std::string& transform) {
+      std::vector<bool> visited(transform.size(), false);
+      for (std::size_t start = 0; start < transform.size(); ++start) {
+        if (visited[start])
+          continue;
+        starts.push_back(order.size());
+        for (std::size_t i = start; !visited[i];
+             i = ToT<std::size_t>(transform[i])) {
+          visited[i] = true;
+          order.push_back(static_cast<std::uint8_t>(i));
+        }
+      }
+      starts.push_back(order.size());
+    }
+
+    // Stores the transform applied |times| times in |power|.
+    void Power(std::uint64_t times, std::vector<std::uint8_t>* power) const {
+      power->resize(order.size());
+      // Byte stores may alias anything, so hoist the data pointers out of the
+      // loops to keep them from being reloaded after every store.
+      std::uint8_t* const output = power->data();
+      for (std::size_t c = 0; c + 1 < starts.size(); ++c) {
+        const std::uint8_t* const cycle = order.data() + starts[c];
+        const std::size_t length = starts[c + 1] - starts[c];
+        const std::size_t shift = static_cast<std::size_t>(times % length);
+        // Element i's image is element i + shift, wrapping around.
+        for (std::size_t i = 0; i < length - shift; ++i)
+          output[cycle[i]] = cycle[i + shift];
+        for (std::size_t i = length - shift; i < length; ++i)
+          output[cycle[i]] = cycle[i + shift - length];
+      }
+    }
+
+    std::vector<std::uint8_t> order;
+    std::vector<std::size_t> starts;
+  };
+
+  // Writes the lineup after |dances| dances to |lineup|, using |positions| and
+  // |names| as scratch space.
+  void Lineup(std::uint64_t dances,
+              std::vector<std::uint8_t>* positions,
+              std::vector<std::uint8_t>* names,
+              char* lineup) const {
+    positions_.Power(dances, positions);
+    names_.Power(dances, names);
+    const std::uint8_t* const position_power = positions->data();
+    const std::uint8_t* const name_power = names->data();
+    for (std::size_t i = 0; i < positions->size(); ++i)
+      lineup[i] = ToT<char>(std::size_t(name_power[position_power[i]]));
+  }
+
+  Cycles positions_;
+  Cycles names_;
+};
+
 }  // namespace
 
-int main(int argc, char* argv[]) {
-  std::cout << "Enter moves, separated by commas: ";
+namespace day16 {
+
+// Like Solve() below, for a dance of |programs| programs instead of the
+// puzzle's 16.  Throws std::invalid_argument if a move doesn't fit that many
+// programs.
+solver::Answers Solve(const std::string& input,
+                      options::Part part,
+                      std::size_t programs) {
+  std::vector<Move> moves;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    moves = CompileMoves(input, programs);
+  }
 
   // Compute the transforms from the input.
-  std::string move;
-  std::string position_transform = GeneratePrograms();
-  std::string name_transform = GeneratePrograms();
-  while (std::getline(std::cin, move, ','))
-    ParseMove(move, &position_transform, &name_transform);
+  instrumentation::Phase phase(instrumentation::kSolve);
+  std::string position_transform = GeneratePrograms(programs);
+  std::string name_transform = GeneratePrograms(programs);
+  ExecuteMoves(moves, &position_transform, &name_transform);
+
+  // Transform the program string.  Both parts query the same transforms.
+  const DanceQueries queries(position_transform, name_transform);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = queries.Lineup(kPart1Dances);
+  if (options::WantsPart2(part))
+    answers.part2 = queries.Lineup(kPart2Dances);
+  return answers;
+}
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  return Solve(input, part, kNumPrograms);
+}
+
+// Returns a random transform of |count| programs, e.g. "dbca" for 4.
+std::string GenerateTransform(std::size_t count, std::mt19937* generator) {
+  std::string transform = GeneratePrograms(count);
+  std::shuffle(transform.begin(), transform.end(), *generator);
+  return transform;
+}
+
+// Times TransformedPrograms() against CycleTransformedPrograms() on random
+// transforms of N programs, for a range of dance counts.
+template<std::size_t N>
+void BenchmarkTransforms() {
+  std::mt19937 generator(2017);
+  constexpr std::size_t kTransforms = 1000;
+  std::vector<std::pair<std::string, std::string>> transforms;
+  for (std::size_t i = 0; i < kTransforms; ++i) {
+    transforms.emplace_back(GenerateTransform(N, &generator),
+                            GenerateTransform(N, &generator));
+  }
+
+  for (std::uint64_t dances : {std::uint64_t(1000000000),
+                               std::uint64_t(0xfedcba9876543210)}) {
+    std::vector<std::string> results(kTransforms), cycle_results(kTransforms);
+    const double seconds =
+        benchmark::MedianSeconds([&transforms, dances, &results]() {
+          for (std::size_t i = 0; i < kTransforms; ++i) {
+            results[i] = TransformedPrograms<N>(
+                transforms[i].first, transforms[i].second, dances);
+          }
+        });
+    const double cycle_seconds =
+        benchmark::MedianSeconds([&transforms, dances, &cycle_results]() {
+          for (std::size_t i = 0; i < kTransforms; ++i) {
+            cycle_results[i] = CycleTransformedPrograms(
+                transforms[i].first, transforms[i].second, dances);
+          }
+        });
+    std::cout << N << " programs, " << dances << " dances: "
+              << seconds / kTransforms * 1e6 << " us, with cycles "
+              << cycle_seconds / kTransforms * 1e6 << " us ("
+              << cycle_seconds / seconds << "x)"
+              << ((results == cycle_results) ? "" : " (MISMATCH)")
+              << std::endl;
+  }
+}
+
+// Returns a random dance of |moves| moves for |count| programs, in the puzzle's
+// text form.
+std::string GenerateDance(std::size_t moves,
+                          std::size_t count = kNumPrograms) {
+  std::mt19937 generator(2017);
+  std::uniform_int_distribution<std::size_t> op(0, 2);
+  std::uniform_int_distribution<std::size_t> program(0, count - 1);
+  std::string dance;
+  for (std::size_t i = 0; i < moves; ++i) {
+    if (i)
+      dance += ',';
+    switch (op(generator)) {
+      case 0:
+        dance += 's' + std::to_string(1 + program(generator) % (count - 1));
+        break;
+      case 1:
+        dance += 'x' + std::to_string(program(generator)) + '/' +
+                 std::to_string(program(generator));
+        break;
+      case 2:
+        dance += 'p';
+        dance += ToT<char>(program(generator));
+        dance += '/';
+        dance += ToT<char>(program(generator));
+        break;
+    }
+  }
+  return dance;
+}
+
+// Times CompileMoves() and ExecuteMoves() against reading moves with
+// std::getline() and ParseMove(), on a random dance of 1,000,000 moves.
+void BenchmarkMoves() {
+  constexpr std::size_t kMoves = 1000000;
+  const std::string dance = GenerateDance(kMoves);
+
+  std::string positions, names;
+  const double compiled_seconds =
+      benchmark::MedianSeconds([&dance, &positions, &names]() {
+        positions = names = GeneratePrograms();
+        ExecuteMoves(CompileMoves(dance), &positions, &names);
+      });
+  const std::vector<Move> moves = CompileMoves(dance);
+  const double execute_seconds =
+      benchmark::MedianSeconds([&moves, &positions, &names]() {
+        positions = names = GeneratePrograms();
+        ExecuteMoves(moves, &positions, &names);
+      });
+
+  std::string parsed_positions, parsed_names;
+  const double parsed_seconds =
+      benchmark::MedianSeconds([&dance, &parsed_positions, &parsed_names]() {
+        parsed_positions = parsed_names = GeneratePrograms();
+        std::istringstream stream(dance);
+        for (std::string move; std::getline(stream, move, ','); )
+          ParseMove(move, &parsed_positions, &parsed_names);
+      });
+
+  const bool matches =
+      (positions == parsed_positions) && (names == parsed_names);
+  std::cout << kMoves << " moves: compile and execute "
+            << kMoves / compiled_seconds << " moves/s (execute alone "
+            << kMoves / execute_seconds << " moves/s), ParseMove() "
+            << kMoves / parsed_seconds << " moves/s"
+            << (matches ? "" : " (MISMATCH)") << std::endl;
+}
+
+// Times 1,000,000 DanceQueries lineup queries, for random dance counts, on
+// dances of N programs, and spot-checks the answers against
+// TransformedPrograms().
+template<std::size_t N>
+void BenchmarkQueries() {
+  std::string positions = GeneratePrograms(N), names = positions;
+  ExecuteMoves(CompileMoves(GenerateDance(10000, N), N), &positions,
+               &names);
 
-  // Transform the program string.
-  std::cout << TransformedPrograms(position_transform, name_transform)
-            << std::endl;
+  std::mt19937_64 generator(2017);
+  constexpr std::size_t kQueries = 1000000;
+  std::vector<std::uint64_t> dances(kQueries);
+  for (auto& count : dances)
+    count = generator();
+
+  const double setup_seconds = benchmark::MedianSeconds(
+      [&positions, &names]() { DanceQueries queries(positions, names); });
+  const DanceQueries queries(positions, names);
+  std::string lineups(kQueries * N, ' ');
+  const double seconds = benchmark::MedianSeconds(
+      [&queries, &dances, &lineups]() {
+        queries.Lineups(dances, &lineups[0]);
+      }, 1);
+
+  bool matches = true;
+  for (std::size_t i = 0; i < kQueries; i += 997) {
+    matches &= lineups.compare(i * N, N, TransformedPrograms<N>(
+                                             positions, names, dances[i])) == 0;
+  }
+  std::cout << N << " programs: setup " << setup_seconds * 1e6 << " us, "
+            << kQueries << " queries in " << seconds * 1000 << " ms ("
+            << seconds / kQueries * 1e9 << " ns/query)"
+            << (matches ? "" : " (MISMATCH)") << std::endl;
+}
+
+void RunBenchmarks() {
+  BenchmarkTransforms<16>();
+  BenchmarkTransforms<256>();
+  BenchmarkMoves();
+  BenchmarkQueries<16>();
+  BenchmarkQueries<256>();
+}
+
+// Times CompileMoves() and ExecuteMoves() on dances of 10,000 moves, the
+// puzzle's length, times each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleMoves = 10000;
+  for (std::size_t scale : suite->Scales(1000)) {
+    const std::size_t moves = kPuzzleMoves * scale;
+    const std::string dance = GenerateDance(moves);
+    suite->Run("CompileMoves()", scale, moves, "moves",
+               [&dance]() { return CompileMoves(dance).size(); });
+    const std::vector<Move> compiled = CompileMoves(dance);
+    suite->Run("ExecuteMoves()", scale, moves, "moves", [&compiled]() {
+      std::string positions = GeneratePrograms(), names = positions;
+      ExecuteMoves(compiled, &positions, &names);
+      return positions;
+    });
+  }
+}
+
+}  // namespace day16
+
+#if !defined(ADVENT_DRIVER)
+int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day16::RunBenchmarks();
+    return 0;
+  }
+
+  // The number of programs defaults to the puzzle's, but can be set with
+  // "--programs=N".  Names are single characters, so there can be at most 256.
+  std::size_t programs = kNumPrograms;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    constexpr std::string_view kProgramsFlag = "--programs=";
+    if (arg.substr(0, kProgramsFlag.size()) != kProgramsFlag)
+      continue;
+    // A value that isn't a number is reported as out of range, below.
+    const char* const value = argv[i] + kProgramsFlag.size();
+    char* end;
+    programs = std::strtoul(value, &end, 10);
+    if ((end == value) || *end || (*value == '-'))
+      programs = 0;
+  }
+  if (!programs || (programs > 256)) {
+    std::cout << "Program count must be from 1 to 256." << std::endl;
+    return 1;
+  }
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
+  std::cout << "Enter moves, separated by commas: ";
+
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
+  solver::Answers answers;
+  try {
+    answers = day16::Solve(input, part, programs);
+  } catch (const std::invalid_argument& e) {
+    std::cout << e.what() << '.' << std::endl;
+    return 1;
+  }
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << answers.part2 << std::endl;
+  }
+  instrumentation::Report(16);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
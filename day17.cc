@@ -1,19 +1,39 @@
 // Advent of Code 2017 day 17 solution
 // Peter Kasting, Dec. 17, 2017
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
 namespace {
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+// The number of values inserted in part 1.
+constexpr std::size_t kPart1Values = 2017;
 
 // Compute the value for part 1, which is the buffer element just after the last
-// inserted value (2017).
-std::size_t Part1Value(std::size_t steps) {
+// inserted value (2017, or |values| in general).  This is the original
+// implementation of Part1Value(), which builds the buffer as a linked list;
+// it's kept as a reference for benchmarking.
+std::size_t ListPart1Value(std::size_t steps,
+                           std::size_t values = kPart1Values) {
   // Build the buffer.  We use both an iterator and a position number, since we
   // need the former to insert/read out values and the latter to simulate the
   // buffer being circular.  (This also lets us reduce the cost of incrementing
@@ -24,9 +44,10 @@ std::size_t Part1Value(std::size_t steps) {
   // this computation O(1), but then the insertions would be O(n) reads and
   // writes in the buffer size, which is even worse.
   std::list<std::size_t> buffer = {0, 1};
-  std::list<std::size_t>::iterator i = buffer.begin();
-  constexpr size_t kValues = 2017;
-  for (std::size_t pos = 0; buffer.size() <= kValues;
+  // The last inserted value, 1, is at position 1.  (Starting at position 0
+  // would put 0 where 1 should be, which matters when the answer is 0 or 1.)
+  std::list<std::size_t>::iterator i = std::next(buffer.begin());
+  for (std::size_t pos = 1; buffer.size() <= values;
        i = buffer.insert(i, buffer.size())) {
     // |new_pos| is actually the "one past" position, i.e. the position to
     // insert before, rather than to insert after.
@@ -44,15 +65,133 @@ std::size_t Part1Value(std::size_t steps) {
   return (i == buffer.end()) ? buffer.front() : *i;
 }
 
+// A sequence of values, stored as a doubly-linked list of chunks, each a
+// fixed-size array holding up to kChunkCapacity values.  The chunks live in
+// one pool and link to each other by index, so splitting a chunk never moves
+// any others.  Inserting shifts values within only one chunk, splitting it in
+// two first if it's full.  Finding the chunk for an index walks chunk by chunk
+// from a cursor left at the last chunk accessed (or from the front, if that's
+// closer), so accesses near the previous one, like the spinlock's, take O(1)
+// chunk hops plus O(kChunkCapacity) shifting.  An arbitrary index costs
+// O(n / kChunkCapacity) hops instead, short of the O(log n) an indexed tree of
+// chunk sizes would give; but the spinlock only moves forward by |steps| + 1 or
+// wraps back near the front, and keeping such an index up to date would slow
+// every insertion and split to speed up seeks it never makes.  The chunk sizes
+// and links are kept apart from the values, so walking past a chunk doesn't
+// pull its values into the cache.
+class ChunkedBuffer {
+ public:
+  ChunkedBuffer() : chunks_(1), values_(1) {}
+
+  std::size_t size() const { return size_; }
+
+  // Returns the value at |index|, which must be less than size().
+  std::uint32_t at(std::size_t index) {
+    Seek(index);
+    return values_[chunk_][index - chunk_start_];
+  }
+
+  // Inserts |value| before the value at |index|, which may be size() to
+  // append.
+  void Insert(std::size_t index, std::uint32_t value) {
+    Seek(index);
+    if (chunks_[chunk_].size == kChunkCapacity) {
+      Split();
+      Seek(index);
+    }
+    std::uint32_t* const values = values_[chunk_].data();
+    const std::size_t offset = index - chunk_start_;
+    std::uint32_t& size = chunks_[chunk_].size;
+    std::copy_backward(values + offset, values + size, values + size + 1);
+    values[offset] = value;
+    ++size;
+    ++size_;
+  }
+
+ private:
+  static constexpr std::size_t kChunkCapacity = 256;
+  static constexpr std::uint32_t kNoChunk =
+      std::numeric_limits<std::uint32_t>::max();
+
+  struct Chunk {
+    std::uint32_t size = 0;
+    std::uint32_t prev = kNoChunk;
+    std::uint32_t next = kNoChunk;
+  };
+
+  // Moves the cursor to the chunk containing |index|.  An index at the end of
+  // a chunk is considered to be in that chunk if it's the last one.
+  void Seek(std::size_t index) {
+    if (index < chunk_start_ / 2)
+      chunk_ = chunk_start_ = 0;  // The first chunk is always chunk 0.
+    while (index < chunk_start_) {
+      chunk_ = chunks_[chunk_].prev;
+      chunk_start_ -= chunks_[chunk_].size;
+    }
+    while ((index >= chunk_start_ + chunks_[chunk_].size) &&
+           (chunks_[chunk_].next != kNoChunk)) {
+      chunk_start_ += chunks_[chunk_].size;
+      chunk_ = chunks_[chunk_].next;
+    }
+  }
+
+  // Moves the back half of the cursor's chunk to a new chunk linked after it.
+  // The cursor stays valid, since its chunk still starts at the same index.
+  void Split() {
+    const auto id = static_cast<std::uint32_t>(chunks_.size());
+    chunks_.emplace_back();
+    values_.emplace_back();
+    Chunk& chunk = chunks_[chunk_];
+    Chunk& back = chunks_[id];
+    const std::uint32_t half = chunk.size / 2;
+    std::copy(values_[chunk_].begin() + half,
+              values_[chunk_].begin() + chunk.size, values_[id].begin());
+    back.size = chunk.size - half;
+    chunk.size = half;
+    back.prev = static_cast<std::uint32_t>(chunk_);
+    back.next = chunk.next;
+    if (chunk.next != kNoChunk)
+      chunks_[chunk.next].prev = id;
+    chunk.next = id;
+  }
+
+  std::vector<Chunk> chunks_;
+  std::vector<std::array<std::uint32_t, kChunkCapacity>> values_;
+  std::size_t size_ = 0;
+
+  // The cursor: the index of a chunk, and the index in the sequence of that
+  // chunk's first value.
+  std::size_t chunk_ = 0;
+  std::size_t chunk_start_ = 0;
+};
+
+// Compute the value for part 1, as above, building the buffer in a
+// ChunkedBuffer.  Values must fit in 32 bits.
+std::size_t Part1Value(std::size_t steps, std::size_t values = kPart1Values) {
+  ChunkedBuffer buffer;
+  buffer.Insert(0, 0);
+  std::size_t pos = 0;  // The position of the last inserted value.
+  for (std::size_t value = 1; value <= values; ++value) {
+    pos = ((pos + steps) % buffer.size()) + 1;
+    buffer.Insert(pos, static_cast<std::uint32_t>(value));
+  }
+  return buffer.at((pos + 1) % buffer.size());
+}
+
+// The number of values inserted in part 2.
+constexpr std::size_t kPart2Values = 50000000;
+
 // Compute the value for part 2, which is the buffer element just after the
-// first element in the buffer (0).
-std::size_t Part2Value(std::size_t steps) {
+// first element in the buffer (0), after inserting |values| values.  This is
+// the original implementation of Part2Value(), which simulates every
+// insertion; it's kept as a reference for benchmarking.
+std::size_t SteppedPart2Value(std::size_t steps,
+                              std::size_t values = kPart2Values) {
   // We don't actually need to build the whole buffer; since 0 never moves from
   // the front of the buffer, all we need to do is simulate the buffer size
   // increasing and see when we would have inserted a value right after 0.
-  constexpr std::size_t kValues = 50000000;
   std::size_t value_after_zero = 1;
-  for (std::size_t pos = 1, buf_size = 2; buf_size <= kValues; ++buf_size) {
+  for (std::size_t pos = 1, buf_size = 2; buf_size <= values; ++buf_size) {
     // |pos| is actually the "one past" position, i.e. the position to
     // insert before, rather than to insert after.  It wouldn't be correct to
     // move the "+ 1" inside the modulus; in the case where the result would be
@@ -67,15 +206,409 @@ std::size_t Part2Value(std::size_t steps) {
   return value_after_zero;
 }
 
+// Compute the value for part 2, as above, but without simulating each
+// insertion.  While the current position plus |steps| stays inside the
+// buffer, each insertion just lands |steps| + 1 past the previous one, which
+// can't be right after 0.  Each such insertion shrinks the gap between the
+// current position and the end of the buffer by |steps|, so the whole run of
+// them can be skipped at once, leaving only the insertions that wrap around
+// to simulate.  Since each run grows the buffer by a factor of about
+// 1 + 1 / |steps|, this takes O(|steps| * log(|values|)) time.
+std::size_t Part2Value(std::size_t steps, std::size_t values = kPart2Values) {
+  if (values < 1)
+    return 0;  // The buffer is just {0}.
+
+  // After inserting value v at position |pos|, the buffer has v + 1 elements.
+  std::size_t value_after_zero = 1;
+  for (std::size_t pos = 1, value = 1; value < values; ) {
+    // Skip the insertions that don't wrap.
+    const std::size_t gap = value - pos;
+    const std::size_t skip =
+        std::min(steps ? (gap / steps) : (values - value), values - value);
+    value += skip;
+    pos += skip * (steps + 1);
+    if (value == values)
+      break;
+
+    // Simulate the next insertion, which wraps.
+    ++value;
+    pos = ((pos + steps) % value) + 1;
+    if (pos == 1)
+      value_after_zero = value;
+  }
+  return value_after_zero;
+}
+
+// Returns, for each of |targets| (none greater than |values|), the value just
+// after it in the buffer that results from inserting |values| values with
+// |steps| steps per insertion.  This generalizes both parts: part 1 asks for
+// the value after |values|, and part 2 the value after 0.
+//
+// Rather than building the buffer, this tracks only the positions of interest.
+// A forward pass replays the insertion positions, following each target's
+// position from when it's inserted to the end, which gives the final position
+// of each target's successor.  Then a backward pass undoes the insertions from
+// last to first, following each successor's position back until it reaches
+// the insertion that put a value there.  Insertion positions can be computed
+// backward, since from position p of value v, the previous position is
+// (p - 1 - |steps|) mod v.
+//
+// As in Part2Value(), runs of insertions that don't wrap are handled at once:
+// their positions are evenly spaced, |steps| + 1 apart, so how many of them
+// land before a tracked position is a single division.  This takes
+// O((|steps| * log(|values|) + |targets|) * |targets|) time and O(|targets|)
+// memory.
+std::vector<std::size_t> ValuesAfter(std::size_t steps,
+                                     std::size_t values,
+                                     const std::vector<std::size_t>& targets) {
+  // Forward pass.  Targets are tracked in increasing order, so that they can
+  // be picked up as they're inserted; |positions[i]| is the current position of
+  // targets[order[i]].  Value 0 is at position 0 from the start, and no value
+  // is ever inserted before it.
+  std::vector<std::size_t> order(targets.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&targets](std::size_t a,
+                                                   std::size_t b) {
+    return targets[a] < targets[b];
+  });
+  std::vector<std::size_t> positions;
+  positions.reserve(targets.size());
+  std::size_t next_target = 0;
+  const auto AddTargets = [&targets, &order, &positions, &next_target](
+                              std::size_t value, std::size_t pos) {
+    for (; (next_target < order.size()) &&
+           (targets[order[next_target]] == value);
+         ++next_target)
+      positions.push_back(pos);
+  };
+  AddTargets(0, 0);
+
+  // After inserting value v at position |pos|, the buffer has v + 1 elements.
+  std::size_t pos = 0;
+  for (std::size_t value = 0; value < values; ) {
+    // The insertions that don't wrap, up to the next target, if any.
+    std::size_t run = std::min(steps ? ((value - pos) / steps)
+                                     : (values - value),
+                               values - value);
+    if (next_target < order.size())
+      run = std::min(run, targets[order[next_target]] - value);
+    if (run) {
+      // Insertion k of the run lands at pos + k * (steps + 1).  A tracked
+      // position q moves up one for each insertion at or before it, which,
+      // since q moves up by one and the insertions by steps + 1, are the
+      // first (q - pos - 1) / steps of them.
+      for (std::size_t& position : positions) {
+        if (position > pos) {
+          position += steps ? std::min(run, (position - pos - 1) / steps)
+                            : run;
+        }
+      }
+      value += run;
+      pos += run * (steps + 1);
+    } else {
+      // This insertion wraps.  Everything at or after it moves up one.
+      ++value;
+      pos = ((pos + steps) % value) + 1;
+      for (std::size_t& position : positions)
+        position += (position >= pos);
+    }
+    AddTargets(value, pos);
+  }
+
+  // Backward pass.  |pending| holds the queries not yet resolved, as pairs of
+  // (current position of the successor, index in |targets|).
+  std::vector<std::pair<std::size_t, std::size_t>> pending;
+  for (std::size_t i = 0; i < positions.size(); ++i)
+    pending.emplace_back((positions[i] + 1) % (values + 1), order[i]);
+  std::vector<std::size_t> results(targets.size(), 0);
+  for (std::size_t value = values; value && !pending.empty(); ) {
+    // |pos| is where |value| was inserted.  If it didn't wrap, neither did the
+    // (pos / (steps + 1)) - 1 insertions before it; their positions step back
+    // by steps + 1 each.
+    const std::size_t run = std::min(pos / (steps + 1), value);
+    for (std::size_t i = 0; i < pending.size(); ) {
+      std::size_t& position = pending[i].first;
+      bool resolved = false;
+      if (!run) {
+        // A single insertion that wrapped.
+        if (position == pos) {
+          results[pending[i].second] = value;
+          resolved = true;
+        } else {
+          position -= (position > pos);
+        }
+      } else if (position > pos) {
+        // Every insertion in the run is before this position.
+        position -= run;
+      } else {
+        // Insertion k of the run (counting back from 0) is at
+        // pos - k * (steps + 1).  The first one at or before |position| either
+        // is this position, or is before it, as are all later ones.
+        const std::size_t first = (pos - position + steps) / (steps + 1);
+        if (first < run) {
+          if (pos - first * (steps + 1) == position) {
+            results[pending[i].second] = value - first;
+            resolved = true;
+          } else {
+            position -= run - first;
+          }
+        }
+      }
+      if (resolved) {
+        pending[i] = pending.back();
+        pending.pop_back();
+      } else {
+        ++i;
+      }
+    }
+
+    if (run) {
+      value -= run;
+      pos -= run * (steps + 1);
+    } else {
+      const std::size_t back = (steps < value) ? steps : (steps % value);
+      pos = (pos - 1 >= back) ? (pos - 1 - back) : (pos - 1 + value - back);
+      --value;
+    }
+  }
+  // Anything left is at position 0, which is value 0.
+  return results;
+}
+
+// Like ValuesAfter() above, for each of |step_counts| in turn, returning the
+// results for each step count in the same order.  The step counts are
+// independent, so they're divided among |threads| threads (or one per
+// hardware thread if |threads| is 0), which claim them one at a time from a
+// shared counter.
+std::vector<std::vector<std::size_t>> ValuesAfter(
+    const std::vector<std::size_t>& step_counts,
+    std::size_t values,
+    const std::vector<std::size_t>& targets,
+    unsigned threads = 0) {
+  std::vector<std::vector<std::size_t>> results(step_counts.size());
+  std::atomic<std::size_t> next(0);
+  const auto Work = [&step_counts, values, &targets, &results, &next]() {
+    for (std::size_t i; (i = next.fetch_add(1)) < step_counts.size(); )
+      results[i] = ValuesAfter(step_counts[i], values, targets);
+  };
+
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  threads = static_cast<unsigned>(std::max<std::size_t>(
+      std::min<std::size_t>(threads, step_counts.size()), 1));
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; ++i)
+    workers.emplace_back(Work);
+  Work();  // The calling thread is one of the workers.
+  for (auto& worker : workers)
+    worker.join();
+  return results;
+}
+
 }  // namespace
 
+namespace day17 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  std::size_t steps = 0;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    std::istringstream stream(input);
+    stream >> steps;
+  }
+
+  // The parts insert different numbers of values, so they share no work.
+  instrumentation::Phase phase(instrumentation::kSolve);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = std::to_string(Part1Value(steps));
+  if (options::WantsPart2(part))
+    answers.part2 = std::to_string(Part2Value(steps));
+  return answers;
+}
+
+// Times Part1Value() against ListPart1Value() on 2017 and 100,000 values, and
+// Part1Value() alone on 1,000,000 and 10,000,000 values.  Each list insertion
+// walks |steps| nodes, nearly every one a cache miss once the list outgrows
+// the cache, so at a million values the list takes minutes.
+void BenchmarkPart1() {
+  constexpr std::size_t kSteps = 348;
+  for (std::size_t values : {kPart1Values, std::size_t(100000),
+                             std::size_t(1000000), std::size_t(10000000)}) {
+    const int runs = (values > kPart1Values) ? 1 : 5;
+    std::size_t value = 0;
+    const double seconds = benchmark::MedianSeconds([values, &value]() {
+      value = Part1Value(kSteps, values);
+    }, runs);
+    std::cout << kSteps << " steps, " << values << " values: " << value
+              << "; chunked " << seconds * 1000 << " ms";
+    if (values <= 100000) {
+      std::size_t list_value = 0;
+      const double list_seconds =
+          benchmark::MedianSeconds([values, &list_value]() {
+            list_value = ListPart1Value(kSteps, values);
+          }, runs);
+      std::cout << ", std::list " << list_seconds * 1000 << " ms"
+                << ((value == list_value) ? "" : " (MISMATCH)");
+    }
+    std::cout << std::endl;
+  }
+}
+
+// Checks Part2Value() against SteppedPart2Value() and times both for several
+// step counts, then times Part2Value() alone on 10^12 values.
+void BenchmarkPart2() {
+  for (std::size_t steps : {3, 348, 386, 3000}) {
+    volatile std::size_t volatile_steps = steps;
+    volatile std::size_t value = 0, stepped_value = 0;
+    const double seconds =
+        benchmark::MedianSeconds([&volatile_steps, &value]() {
+          value = Part2Value(volatile_steps);
+        });
+    const double stepped_seconds =
+        benchmark::MedianSeconds([&volatile_steps, &stepped_value]() {
+          stepped_value = SteppedPart2Value(volatile_steps);
+        }, 1);
+    std::cout << steps << " steps, " << kPart2Values << " values: " << value
+              << "; skipping " << seconds * 1e6 << " us, stepping "
+              << stepped_seconds * 1e6 << " us"
+              << ((value == stepped_value) ? "" : " (MISMATCH)") << std::endl;
+  }
+
+  constexpr std::size_t kLargeValues = 1000000000000;
+  volatile std::size_t volatile_steps = 348;
+  volatile std::size_t value = 0;
+  const double seconds = benchmark::MedianSeconds([&volatile_steps, &value]() {
+    value = Part2Value(volatile_steps, kLargeValues);
+  });
+  std::cout << volatile_steps << " steps, " << kLargeValues << " values: "
+            << value << "; skipping " << seconds * 1e6 << " us" << std::endl;
+}
+
+// Checks ValuesAfter() against a fully built buffer, and against Part1Value()
+// and Part2Value(), then times it for 16 step counts at once from one thread
+// up to one per hardware thread.
+void BenchmarkQueries() {
+  std::mt19937 generator(2017);
+  constexpr std::size_t kSteps = 348;
+
+  // Build a 100,000-value buffer and compare 100 random targets' successors.
+  constexpr std::size_t kBufferValues = 100000;
+  ChunkedBuffer buffer;
+  buffer.Insert(0, 0);
+  std::vector<std::size_t> positions(kBufferValues + 1, 0);
+  for (std::size_t value = 1, pos = 0; value <= kBufferValues; ++value) {
+    pos = ((pos + kSteps) % buffer.size()) + 1;
+    buffer.Insert(pos, static_cast<std::uint32_t>(value));
+  }
+  for (std::size_t i = 0; i < buffer.size(); ++i)
+    positions[buffer.at(i)] = i;
+  std::vector<std::size_t> targets(100);
+  for (auto& target : targets)
+    target = generator() % (kBufferValues + 1);
+  const std::vector<std::size_t> results =
+      ValuesAfter(kSteps, kBufferValues, targets);
+  bool matches = true;
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    matches &= results[i] ==
+               buffer.at((positions[targets[i]] + 1) % buffer.size());
+  }
+
+  // The puzzle's answers are also special cases.
+  matches &= ValuesAfter(kSteps, kPart1Values, {kPart1Values})[0] ==
+             Part1Value(kSteps);
+  matches &= ValuesAfter(kSteps, kPart2Values, {0})[0] == Part2Value(kSteps);
+  std::cout << "ValuesAfter() checks" << (matches ? "" : " (MISMATCH)")
+            << std::endl;
+
+  // Time 16 step counts, with 100 targets each, on 1,000,000,000 values.
+  constexpr std::size_t kValues = 1000000000;
+  std::vector<std::size_t> step_counts(16);
+  for (auto& steps : step_counts)
+    steps = 1 + generator() % 1000;
+  for (auto& target : targets)
+    target = generator() % (kValues + 1);
+  const std::vector<std::vector<std::size_t>> expected =
+      ValuesAfter(step_counts, kValues, targets, 1);
+  const unsigned max_threads =
+      std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1; ; threads = std::min(threads * 2, max_threads)) {
+    std::vector<std::vector<std::size_t>> all_results;
+    const double seconds = benchmark::MedianSeconds(
+        [&step_counts, &targets, threads, &all_results]() {
+          all_results = ValuesAfter(step_counts, kValues, targets, threads);
+        });
+    std::cout << step_counts.size() << " step counts, " << targets.size()
+              << " targets, " << kValues << " values, " << threads
+              << " threads: " << seconds * 1000 << " ms"
+              << ((all_results == expected) ? "" : " (MISMATCH)") << std::endl;
+    if (threads == max_threads)
+      break;
+  }
+}
+
+void RunBenchmarks() {
+  BenchmarkPart1();
+  BenchmarkPart2();
+  BenchmarkQueries();
+}
+
+// Times Part1Value() and Part2Value() on the puzzle's value counts times each
+// scale, for a random step count like the puzzle's.  Part2Value() skips most
+// values, so it can go to much larger scales than Part1Value(), which builds
+// the whole buffer.
+void RunSuite(benchmark::Suite* suite) {
+  std::mt19937 generator(2017);
+  const std::size_t steps = 300 + generator() % 100;
+  for (std::size_t scale : suite->Scales(1000)) {
+    const std::size_t values = kPart1Values * scale;
+    suite->Run("Part1Value()", scale, static_cast<double>(values), "values",
+               [steps, values]() {
+      return Part1Value(benchmark::HideInput(steps),
+                        benchmark::HideInput(values));
+    });
+  }
+  for (std::size_t scale : suite->Scales(1000000)) {
+    const std::size_t values = kPart2Values * scale;
+    suite->Run("Part2Value()", scale, static_cast<double>(values), "values",
+               [steps, values]() {
+      return Part2Value(benchmark::HideInput(steps),
+                        benchmark::HideInput(values));
+    });
+  }
+}
+
+}  // namespace day17
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    day17::RunBenchmarks();
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter steps: ";
-  std::size_t steps;
-  std::cin >> steps;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::cin >> input;
+  }
 
-  std::cout << "Value: " << (kPart1 ? Part1Value(steps) : Part2Value(steps))
-            << std::endl;
+  const solver::Answers answers = day17::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Value: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Value: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(17);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
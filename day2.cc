@@ -2,37 +2,44 @@
 // Peter Kasting, Dec. 4, 2017
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <sstream>
 #include <string>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // Tokenizes |input|, a series of whitespace-delimited ints, to a vector of
 // ints.
 std::vector<int> Tokenize(const std::string& input) {
   std::vector<int> tokenized;
-  std::transform(std::istream_iterator<std::string>(std::istringstream(input)),
+  std::istringstream stringstream(input);
+  std::transform(std::istream_iterator<std::string>(stringstream),
                  std::istream_iterator<std::string>(),
                  std::back_inserter(tokenized),
                  [](const std::string& str) { return std::stoi(str); });
   return tokenized;
 }
 
-// Computes the checksum portion for the given |row|.  In part 1, this is the
-// difference between the largest and smallest elements; in part 2, the quotient
-// of the two elements that evenly divide.
-int ComputeRowChecksum(const std::vector<int>& row) {
-  if (kPart1) {
-    // Return the difference between the smallest and largest elements.
-    const auto minmax_iters = std::minmax_element(row.cbegin(), row.cend());
-    return *minmax_iters.second - *minmax_iters.first;
-  }
+// Computes the part 1 checksum portion for the given |row|, the difference
+// between the largest and smallest elements.
+int RowDifference(const std::vector<int>& row) {
+  const auto minmax_iters = std::minmax_element(row.cbegin(), row.cend());
+  return *minmax_iters.second - *minmax_iters.first;
+}
 
+// Computes the part 2 checksum portion for the given |row|, the quotient of the
+// two elements that evenly divide.
+int RowQuotient(const std::vector<int>& row) {
   // Find the pair of elements where the smaller evenly divides the larger.
   //
   // This uses brute-force comparison of all pairs, which is n^2.  We could sort
@@ -50,18 +57,112 @@ int ComputeRowChecksum(const std::vector<int>& row) {
 
 }  // namespace
 
-int main(int argc, char* argv[]) {
-  // Read input line-at-a-time and compute running checksum.
+namespace day2 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  const bool part1 = options::WantsPart1(part);
+  const bool part2 = options::WantsPart2(part);
+
+  // Compute running checksums a row at a time, tokenizing each row only once
+  // even when computing both.
   //
   // We could store the row checksums in a vector and use std::accumulate(), but
   // that would require more memory.
+  std::istringstream stream(input);
+  std::string line;
+  int difference_checksum = 0, quotient_checksum = 0;
+  while (std::getline(stream, line)) {
+    std::vector<int> row;
+    {
+      instrumentation::Phase phase(instrumentation::kParse);
+      row = Tokenize(line);
+    }
+    instrumentation::Phase phase(instrumentation::kSolve);
+    if (part1)
+      difference_checksum += RowDifference(row);
+    if (part2)
+      quotient_checksum += RowQuotient(row);
+  }
+  return {part1 ? std::to_string(difference_checksum) : std::string(),
+          part2 ? std::to_string(quotient_checksum) : std::string()};
+}
+
+// Returns a spreadsheet of |rows| rows of 16 random numbers.  As in the puzzle
+// input, each row has a pair of numbers where one evenly divides the other.
+std::string GenerateSpreadsheet(std::size_t rows) {
+  constexpr std::size_t kColumns = 16;
+  std::mt19937 generator(2017);
+  std::string spreadsheet;
+  for (std::size_t i = 0; i < rows; ++i) {
+    int row[kColumns];
+    for (int& value : row)
+      value = static_cast<int>(100 + generator() % 5000);
+    const int divisor = static_cast<int>(2 + generator() % 98);
+    row[generator() % kColumns] = divisor;
+    std::size_t multiple;
+    do
+      multiple = generator() % kColumns;
+    while (row[multiple] == divisor);
+    row[multiple] = divisor * static_cast<int>(2 + generator() % 50);
+    for (std::size_t column = 0; column < kColumns; ++column)
+      spreadsheet += std::to_string(row[column]) + '\t';
+    spreadsheet.back() = '\n';
+  }
+  return spreadsheet;
+}
+
+// Times RowDifference() and RowQuotient() on 16 rows, the puzzle's size, times
+// each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleRows = 16;
+  for (std::size_t scale : suite->Scales(100000)) {
+    std::istringstream stream(GenerateSpreadsheet(kPuzzleRows * scale));
+    std::vector<std::vector<int>> rows;
+    for (std::string line; std::getline(stream, line); )
+      rows.push_back(Tokenize(line));
+
+    suite->Run("RowDifference()", scale, rows.size(), "rows", [&rows]() {
+      std::int64_t checksum = 0;  // Large scales overflow an int.
+      for (const auto& row : rows)
+        checksum += RowDifference(row);
+      return checksum;
+    });
+    suite->Run("RowQuotient()", scale, rows.size(), "rows", [&rows]() {
+      std::int64_t checksum = 0;
+      for (const auto& row : rows)
+        checksum += RowQuotient(row);
+      return checksum;
+    });
+  }
+}
+
+}  // namespace day2
+
+#if !defined(ADVENT_DRIVER)
+int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter spreadsheet rows; terminate with ctrl-z alone on a line."
             << std::endl;
-  std::string row;
-  int checksum = 0;
-  while (std::getline(std::cin, row))
-    checksum += ComputeRowChecksum(Tokenize(row));
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
 
-  std::cout << "Checksum is: " << checksum << std::endl;
+  const solver::Answers answers = day2::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Checksum is: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Checksum is: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(2);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
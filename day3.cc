@@ -6,13 +6,20 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
 #include <tuple>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // A dynamically-sized two-dimensional block of simulated memory.  We could save
 // quite a bit of code by using a std::map<std::pair<int, int>, int> to store
@@ -152,14 +159,83 @@ int FirstLargerValue(int input) {
 
 }  // namespace
 
+namespace day3 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  int value = 0;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    std::istringstream stream(input);
+    stream >> value;
+  }
+
+  // The two parts share nothing but the input.
+  instrumentation::Phase phase(instrumentation::kSolve);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = std::to_string(ManhattanDistance(value));
+  if (options::WantsPart2(part))
+    answers.part2 = std::to_string(FirstLargerValue(value));
+  return answers;
+}
+
+// Returns |count| random puzzle inputs, values from 100,000 to 999,999, as the
+// puzzle's are.
+std::vector<int> GenerateValues(std::size_t count) {
+  std::mt19937 generator(2017);
+  std::vector<int> values(count);
+  for (int& value : values)
+    value = static_cast<int>(100000 + generator() % 900000);
+  return values;
+}
+
+// Times ManhattanDistance() and FirstLargerValue().  The puzzle input is a
+// single value, so each scale is a number of values.
+void RunSuite(benchmark::Suite* suite) {
+  for (std::size_t scale : suite->Scales(100000)) {
+    const std::vector<int> values = GenerateValues(scale);
+    suite->Run("ManhattanDistance()", scale, values.size(), "values",
+               [&values]() {
+      std::int64_t sum = 0;
+      for (int value : values)
+        sum += ManhattanDistance(benchmark::HideInput(value));
+      return sum;
+    });
+    suite->Run("FirstLargerValue()", scale, values.size(), "values",
+               [&values]() {
+      std::int64_t sum = 0;
+      for (int value : values)
+        sum += FirstLargerValue(benchmark::HideInput(value));
+      return sum;
+    });
+  }
+}
+
+}  // namespace day3
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter value: ";
-  int input;
-  std::cin >> input;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::cin >> input;
+  }
 
-  if (kPart1)
-    std::cout << "Steps required: " << ManhattanDistance(input) << std::endl;
-  else
-    std::cout << "First larger value: " << FirstLargerValue(input) << std::endl;
+  const solver::Answers answers = day3::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Steps required: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "First larger value: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(3);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
@@ -2,34 +2,46 @@
 // Peter Kasting, Dec. 4, 2017
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <sstream>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
-// Returns true if |passphrase| is valid.  In part 1, a valid passphrase
-// contains no duplicate words.  In part 2, it contains no words that are
-// anagrams of each other.
-bool PassphraseValid(const std::string& passphrase) {
-  // Convert the passphrase to a set of words, checking each against previous
-  // words in the passphrase.
+// Breaks |passphrase| into its whitespace-delimited words.
+std::vector<std::string> Tokenize(const std::string& passphrase) {
   std::istringstream stringstream(passphrase);
-  std::unordered_set<std::string> words;
-  const auto ProcessWord = [](std::string word) {
-    if (!kPart1) {
+  return std::vector<std::string>(
+             (std::istream_iterator<std::string>(stringstream)),
+             std::istream_iterator<std::string>());
+}
+
+// Returns true if the passphrase made up of |words| is valid.  In part 1, a
+// valid passphrase contains no duplicate words.  In part 2, it contains no
+// words that are anagrams of each other.
+bool PassphraseValid(const std::vector<std::string>& words, bool part1) {
+  // Check each word against the previous words in the passphrase.
+  std::unordered_set<std::string> words_seen;
+  const auto ProcessWord = [part1](std::string word) {
+    if (!part1) {
       // Map all anagrams to the same word by sorting the characters.
       std::sort(word.begin(), word.end());
     }
     return word;
   };
-  for (std::istream_iterator<std::string> i(stringstream), end; i != end; ++i) {
+  for (const std::string& word : words) {
     // If the next word was already seen, mark the passphrase invalid.
-    if (!words.insert(ProcessWord(*i)).second)
+    if (!words_seen.insert(ProcessWord(word)).second)
       return false;
   }
   return true;
@@ -37,20 +49,106 @@ bool PassphraseValid(const std::string& passphrase) {
 
 }  // namespace
 
-int main(int argc, char* argv[]) {
-  // Read input line-at-a-time and compute running count of valid passphrases.
+namespace day4 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  const bool part1 = options::WantsPart1(part);
+  const bool part2 = options::WantsPart2(part);
+
+  // Compute running counts of valid passphrases a line at a time.
   //
   // We could store the passphrases in a vector and use std::count_if(), but
   // that would require more memory.
+  std::istringstream stream(input);
+  std::string passphrase;
+  int valid_passphrases[2] = {0, 0};
+  while (std::getline(stream, passphrase)) {
+    std::vector<std::string> words;
+    {
+      instrumentation::Phase phase(instrumentation::kParse);
+      words = Tokenize(passphrase);
+    }
+    instrumentation::Phase phase(instrumentation::kSolve);
+    // Any two duplicate words are also anagrams, so a passphrase valid in part
+    // 2 is valid in part 1 too, and needn't be checked again.
+    const bool valid2 = part2 && PassphraseValid(words, false);
+    if (part1 && (valid2 || PassphraseValid(words, true)))
+      ++valid_passphrases[0];
+    if (valid2)
+      ++valid_passphrases[1];
+  }
+  return {part1 ? std::to_string(valid_passphrases[0]) : std::string(),
+          part2 ? std::to_string(valid_passphrases[1]) : std::string()};
+}
+
+// Returns |count| passphrases of 5 to 10 random words.  The words are 2 to 5
+// letters from a small alphabet, so that some passphrases repeat words or
+// anagrams, as in the puzzle input.
+std::string GeneratePassphrases(std::size_t count) {
+  std::mt19937 generator(2017);
+  std::string passphrases;
+  for (std::size_t i = 0; i < count; ++i) {
+    for (std::size_t words = 5 + generator() % 6; words; --words) {
+      for (std::size_t letters = 2 + generator() % 4; letters; --letters)
+        passphrases += static_cast<char>('a' + generator() % 8);
+      passphrases += (words == 1) ? '\n' : ' ';
+    }
+  }
+  return passphrases;
+}
+
+// Times PassphraseValid() for each part on 512 passphrases, the puzzle's size,
+// times each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzlePassphrases = 512;
+  for (std::size_t scale : suite->Scales(1000)) {
+    std::istringstream stream(
+        GeneratePassphrases(kPuzzlePassphrases * scale));
+    std::vector<std::vector<std::string>> passphrases;
+    for (std::string line; std::getline(stream, line); )
+      passphrases.push_back(Tokenize(line));
+
+    for (bool part1 : {true, false}) {
+      suite->Run(part1 ? "PassphraseValid(), part 1"
+                       : "PassphraseValid(), part 2",
+                 scale, passphrases.size(), "passphrases",
+                 [&passphrases, part1]() {
+        std::size_t valid = 0;
+        for (const auto& words : passphrases)
+          valid += PassphraseValid(words, part1);
+        return valid;
+      });
+    }
+  }
+}
+
+}  // namespace day4
+
+#if !defined(ADVENT_DRIVER)
+int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter passphrases; terminate with ctrl-z alone on a line."
             << std::endl;
-  std::string passphrase;
-  int valid_passphrases = 0;
-  while (std::getline(std::cin, passphrase)) {
-    if (PassphraseValid(passphrase))
-      ++valid_passphrases;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
   }
 
-  std::cout << "Valid passphrases: " << valid_passphrases << std::endl;
+  const solver::Answers answers = day4::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Valid passphrases: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Valid passphrases: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(4);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
@@ -5,22 +5,28 @@
 #include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
-// Reads whitespace-delimited ints on std::cin and returns a vector containing
-// them.
-std::vector<int> ReadInput() {
-  std::vector<int> input;
-  std::transform(std::istream_iterator<std::string>(std::cin),
+// Tokenizes |input|, a series of whitespace-delimited ints, to a vector of
+// ints.
+std::vector<int> Tokenize(const std::string& input) {
+  std::vector<int> tokenized;
+  std::istringstream stringstream(input);
+  std::transform(std::istream_iterator<std::string>(stringstream),
                  std::istream_iterator<std::string>(),
-                 std::back_inserter(input),
+                 std::back_inserter(tokenized),
                  [](const std::string& str) { return std::stoi(str); });
-  return input;
+  return tokenized;
 }
 
 // Counts the number of steps needed to exit |offsets|, starting from the first
@@ -28,7 +34,7 @@ std::vector<int> ReadInput() {
 // current offset, and the offset is modified.  In part 1, the offset is always
 // incremented by one; in part 2, the offset is incremented by 1 if less than 3,
 // or decremented by 1 otherwise.
-std::size_t CountSteps(std::vector<int> offsets) {
+std::size_t CountSteps(std::vector<int> offsets, bool part1) {
   std::size_t steps = 0;
   // We could make |pc| a size_t and eliminate the "positive" check, but this
   // assumes that any jump off the beginning of the list is not so large that it
@@ -39,17 +45,91 @@ std::size_t CountSteps(std::vector<int> offsets) {
        ++steps) {
     int& offset = offsets[pc];
     pc += offset;
-    offset += (kPart1 || (offset < 3)) ? 1 : -1;
+    offset += (part1 || (offset < 3)) ? 1 : -1;
   }
   return steps;
 }
 
 }  // namespace
 
+namespace day5 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  std::vector<int> offsets;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    offsets = Tokenize(input);
+  }
+
+  // Each part modifies its own copy of the offsets as it runs.
+  instrumentation::Phase phase(instrumentation::kSolve);
+  solver::Answers answers;
+  if (options::WantsPart1(part))
+    answers.part1 = std::to_string(CountSteps(offsets, true));
+  if (options::WantsPart2(part))
+    answers.part2 = std::to_string(CountSteps(offsets, false));
+  return answers;
+}
+
+// Returns |count| random jump offsets, one per line.  Each offset jumps back by
+// up to 20 or forward by up to 2.  The puzzle's offsets jump back much further,
+// which makes the step count grow with the square of the offset count; keeping
+// the jumps short makes it grow linearly instead, so large scales stay
+// feasible.
+std::string GenerateOffsets(std::size_t count) {
+  std::mt19937 generator(2017);
+  std::string offsets;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::size_t back = std::min<std::size_t>(i, 20);
+    const int offset = static_cast<int>(generator() % 3) -
+                       static_cast<int>(generator() % (back + 1));
+    offsets += std::to_string(offset) + '\n';
+  }
+  return offsets;
+}
+
+// Times CountSteps() for each part on 1,000 offsets, the puzzle's size, times
+// each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleOffsets = 1000;
+  for (std::size_t scale : suite->Scales(10000)) {
+    const std::vector<int> offsets =
+        Tokenize(GenerateOffsets(kPuzzleOffsets * scale));
+    for (bool part1 : {true, false}) {
+      suite->Run(part1 ? "CountSteps(), part 1" : "CountSteps(), part 2",
+                 scale, CountSteps(offsets, part1), "steps",
+                 [&offsets, part1]() { return CountSteps(offsets, part1); });
+    }
+  }
+}
+
+}  // namespace day5
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter jump offsets; terminate with ctrl-z alone on a line."
             << std::endl;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
 
-  std::cout << "Steps to exit: " << CountSteps(ReadInput()) << std::endl;
+  const solver::Answers answers = day5::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Steps to exit: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Steps to exit: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(5);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
@@ -2,8 +2,10 @@
 // Peter Kasting, Dec. 5, 2017
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -11,15 +13,19 @@
 #include <utility>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // Tokenizes |input|, a series of whitespace-delimited ints, to a vector of
 // ints.
 std::vector<int> Tokenize(const std::string& input) {
   std::vector<int> tokenized;
-  std::transform(std::istream_iterator<std::string>(std::istringstream(input)),
+  std::istringstream stringstream(input);
+  std::transform(std::istream_iterator<std::string>(stringstream),
                  std::istream_iterator<std::string>(),
                  std::back_inserter(tokenized),
                  [](const std::string& str) { return std::stoi(str); });
@@ -49,9 +55,9 @@ void Redistribute(std::vector<int>* banks) {
 }
 
 // Continually redistributes the blocks in |banks| until the same configuration
-// recurs.  In part 1, returns the number of cycles required for this to occur;
-// in part 2, returns the number of cycles spanned by the loop.
-int CountCycles(std::vector<int> banks) {
+// recurs.  Returns the number of cycles required for this to occur (for part
+// 1), and the number of cycles spanned by the loop (for part 2).
+std::tuple<int, int> CountCycles(std::vector<int> banks) {
   int cycles = 0;
   // Each bank configuration we've seen before, and on which cycle count.
   std::unordered_map<std::string, int> configs_seen;
@@ -61,7 +67,7 @@ int CountCycles(std::vector<int> banks) {
   // true if this is a new configuration; if not, points |loop_point| to the
   // entry containing the original cycle count for this configuration.
   bool new_config;
-  auto Record = [&loop_point, &new_config, &configs_seen, banks, cycles]() {
+  auto Record = [&loop_point, &new_config, &configs_seen, &banks, &cycles]() {
     std::tie(loop_point, new_config) =
       configs_seen.insert({Serialize(banks), cycles});
   };
@@ -72,16 +78,78 @@ int CountCycles(std::vector<int> banks) {
     ++cycles;
   }
 
-  return cycles - (kPart1 ? 0 : loop_point->second);
+  return {cycles, cycles - loop_point->second};
 }
 
 }  // namespace
 
+namespace day6 {
+
+solver::Answers Solve(const std::string& input, options::Part) {
+  std::vector<int> banks;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    banks = Tokenize(input.substr(0, input.find('\n')));
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  const auto cycles = CountCycles(banks);
+  return {std::to_string(std::get<0>(cycles)),
+          std::to_string(std::get<1>(cycles))};
+}
+
+// Returns |count| random configurations of 16 banks of 0 to 15 blocks, as in
+// the puzzle input.
+std::vector<std::vector<int>> GenerateBanks(std::size_t count) {
+  std::mt19937 generator(2017);
+  std::vector<std::vector<int>> configs(count, std::vector<int>(16));
+  for (auto& banks : configs) {
+    for (int& blocks : banks)
+      blocks = static_cast<int>(generator() % 16);
+  }
+  return configs;
+}
+
+// Times CountCycles().  Growing the banks would make the cycle counts explode,
+// so each scale is instead a number of puzzle-sized configurations.
+void RunSuite(benchmark::Suite* suite) {
+  for (std::size_t scale : suite->Scales(100)) {
+    const std::vector<std::vector<int>> configs = GenerateBanks(scale);
+    suite->Run("CountCycles()", scale, configs.size(), "configurations",
+               [&configs]() {
+      std::size_t cycles = 0;
+      for (const auto& banks : configs)
+        cycles += std::get<0>(CountCycles(banks));
+      return cycles;
+    });
+  }
+}
+
+}  // namespace day6
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter block counts: ";
   std::string input;
-  std::getline(std::cin, input);
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::getline(std::cin, input);
+  }
 
-  std::cout << "Cycles: " << CountCycles(Tokenize(input)) << std::endl;
+  const solver::Answers answers = day6::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Cycles: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Cycles: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(6);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
@@ -7,6 +7,7 @@
 #include <iterator>
 #include <memory>
 #include <numeric>
+#include <random>
 #include <regex>
 #include <sstream>
 #include <string>
@@ -15,6 +16,11 @@
 #include <unordered_set>
 #include <vector>
 
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
+
 /* Some test inputs to exercise edge cases:
  * Nodes with only one child:
 
@@ -71,8 +77,6 @@ Desired output: 10
 
 namespace {
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
-
 class Node {
  public:
   Node(int weight, std::vector<std::string> child_names);
@@ -233,31 +237,165 @@ std::string RootProgram(const std::unordered_map<std::string, Node>& programs,
 
 }  // namespace
 
-int main(int argc, char* argv[]) {
-  // Read input line-at-a-time and parse into program nodes.
-  std::cout << "Enter program data; terminate with ctrl-z alone on a line."
-            << std::endl;
-  std::string program_info;
+namespace day7 {
+
+solver::Answers Solve(const std::string& input, options::Part part) {
+  // Parse the input line-at-a-time into program nodes.
   std::unordered_map<std::string, Node> programs;
   std::unordered_set<std::string> subprograms;
-  while (std::getline(std::cin, program_info))
-    programs.insert(ParseProgramInfo(program_info, &subprograms));
-
-  // Compute root program.
-  const std::string root_name = RootProgram(programs, subprograms);
-  if (kPart1) {
-    // This is all we need for part 1.
-    std::cout << "Bottom program: " << root_name << std::endl;
-  } else {
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    std::istringstream stream(input);
+    std::string program_info;
+    while (std::getline(stream, program_info))
+      programs.insert(ParseProgramInfo(program_info, &subprograms));
+  }
+
+  // Compute root program.  This is all we need for part 1, and where part 2
+  // starts.
+  instrumentation::Phase phase(instrumentation::kSolve);
+  solver::Answers answers;
+  answers.part1 = RootProgram(programs, subprograms);
+  if (options::WantsPart2(part)) {
     // Convert the nodes to a true tree structure.  We could avoid this by doing
     // map lookups each time a node needed to access a child, but since we have
     // to visit all the nodes at least once anyway for that, we might as well
     // use a tree.  This also makes the code in the Node class cleaner, since
     // use of the map is limited to Node::MakeTree().
-    Node* root = &programs.find(root_name)->second;
+    Node* root = &programs.find(answers.part1)->second;
     root->MakeTree(&programs);
-    std::cout << "Replacement weight: " << root->ReplacementWeight()
-              << std::endl;
+    answers.part2 = std::to_string(root->ReplacementWeight());
+  }
+  return answers;
+}
+
+// Returns a tower of at least |programs| programs in the puzzle's text form,
+// with the lines in random order.  The bottom program holds at least three
+// balanced subtowers, each four levels deep with three to seven programs on
+// every disc, and then one program other than the bottom one has its weight
+// changed, as in the puzzle.
+std::string GenerateTower(std::size_t programs) {
+  std::mt19937 generator(2017);
+  std::vector<int> weights;
+  std::vector<std::vector<std::size_t>> children;
+
+  // Adds a subtower |depth| levels above its bottom program, weighing |total|
+  // in all, and returns the bottom program.
+  const auto AddSubtower = [&](const auto& self, int depth,
+                                int total) -> std::size_t {
+    const std::size_t program = weights.size();
+    weights.push_back(total);
+    children.emplace_back();
+    const int count = static_cast<int>(3 + generator() % 5);
+    const int max_child_total = (total - 1) / count;
+    if (depth && (max_child_total >= 10)) {
+      const int child_total =
+          max_child_total / 2 +
+          static_cast<int>(generator() % (max_child_total / 2 + 1));
+      weights[program] = total - count * child_total;
+      for (int i = 0; i < count; ++i) {
+        const std::size_t child = self(self, depth - 1, child_total);
+        children[program].push_back(child);
+      }
+    }
+    return program;
+  };
+  weights.push_back(static_cast<int>(10 + generator() % 90));
+  children.emplace_back();
+  const int subtower_total = static_cast<int>(500000 + generator() % 500000);
+  while ((children[0].size() < 3) || (weights.size() < programs)) {
+    const std::size_t child = AddSubtower(AddSubtower, 3, subtower_total);
+    children[0].push_back(child);
+  }
+
+  const std::size_t wrong = 1 + generator() % (weights.size() - 1);
+  const int change = static_cast<int>(1 + generator() % 9);
+  weights[wrong] += (weights[wrong] > change) ? -change : change;
+
+  // Names are the programs' indexes as base 26 "digits", at least four long.
+  const auto Name = [](std::size_t program) {
+    std::string name;
+    for (std::size_t length = 0; (length < 4) || program; ++length) {
+      name += static_cast<char>('a' + program % 26);
+      program /= 26;
+    }
+    return name;
+  };
+  std::vector<std::string> lines;
+  for (std::size_t program = 0; program < weights.size(); ++program) {
+    std::string line =
+        Name(program) + " (" + std::to_string(weights[program]) + ")";
+    for (std::size_t i = 0; i < children[program].size(); ++i)
+      line += (i ? ", " : " -> ") + Name(children[program][i]);
+    lines.push_back(std::move(line));
+  }
+  std::shuffle(lines.begin(), lines.end(), generator);
+  std::string tower;
+  for (const std::string& line : lines)
+    tower += line + '\n';
+  return tower;
+}
+
+// Times parsing with ParseProgramInfo(), RootProgram() on the parsed programs,
+// and the whole of Solve(), on towers of 1,000 programs, about the puzzle's
+// size, times each scale.  Building the tree modifies the programs, so it's
+// only timed as part of Solve().
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzlePrograms = 1000;
+  for (std::size_t scale : suite->Scales(10)) {
+    const std::string input = GenerateTower(kPuzzlePrograms * scale);
+    std::vector<std::string> lines;
+    std::istringstream stream(input);
+    for (std::string line; std::getline(stream, line); )
+      lines.push_back(line);
+
+    std::unordered_map<std::string, Node> programs;
+    std::unordered_set<std::string> subprograms;
+    suite->Run("ParseProgramInfo()", scale, lines.size(), "programs",
+               [&lines, &programs, &subprograms]() {
+      programs.clear();
+      subprograms.clear();
+      for (const std::string& line : lines)
+        programs.insert(ParseProgramInfo(line, &subprograms));
+      return programs.size();
+    });
+    suite->Run("RootProgram()", scale, lines.size(), "programs",
+               [&programs, &subprograms]() {
+      return RootProgram(programs, subprograms);
+    });
+    suite->Run("Solve()", scale, lines.size(), "programs", [&input]() {
+      return Solve(input, options::Part::kBoth);
+    });
+  }
+}
+
+}  // namespace day7
+
+#if !defined(ADVENT_DRIVER)
+int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
+  std::cout << "Enter program data; terminate with ctrl-z alone on a line."
+            << std::endl;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
+
+  const solver::Answers answers = day7::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Bottom program: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Replacement weight: " << answers.part2 << std::endl;
   }
+  instrumentation::Report(7);
   return 0;
 }
+#endif  // !defined(ADVENT_DRIVER)
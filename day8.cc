@@ -2,21 +2,27 @@
 // Peter Kasting, Dec. 7, 2017
 
 #include <algorithm>
+#include <cstddef>
 #include <iostream>
 #include <iterator>
+#include <random>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // Breaks a string of whitespace-delimited tokens to a vector of tokens.
 std::vector<std::string> Tokenize(const std::string& input) {
+  std::istringstream stringstream(input);
   return std::vector<std::string>(
-             (std::istream_iterator<std::string>(std::istringstream(input))),
+             (std::istream_iterator<std::string>(stringstream)),
              std::istream_iterator<std::string>());
 }
 
@@ -64,22 +70,101 @@ int MaxValue(const std::unordered_map<std::string, int> registers) {
 
 }  // namespace
 
-int main(int argc, char* argv[]) {
-  std::cout << "Enter instructions; terminate with ctrl-z alone on a line."
-            << std::endl;
+namespace day8 {
 
-  // Read input line-at-a-time and execute it on the fly, keeping track of the
-  // largest value written.
+solver::Answers Solve(const std::string& input, options::Part) {
+  // Execute the input line-at-a-time, keeping track of the largest value
+  // written.
+  std::istringstream stream(input);
   std::string line;
   int max_value = 0;
   std::unordered_map<std::string, int> registers;
-  while (std::getline(std::cin, line))
-    max_value = std::max(max_value, Execute(Tokenize(line), &registers));
+  while (std::getline(stream, line)) {
+    std::vector<std::string> tokens;
+    {
+      instrumentation::Phase phase(instrumentation::kParse);
+      tokens = Tokenize(line);
+    }
+    instrumentation::Phase phase(instrumentation::kSolve);
+    max_value = std::max(max_value, Execute(tokens, &registers));
+  }
+
+  // In part 1, the answer is the largest value currently in the register file;
+  // in part 2, the largest value written.  Both come from the same run.
+  return {std::to_string(MaxValue(registers)), std::to_string(max_value)};
+}
+
+// Returns |count| random instructions on 26 registers, one per line.  Like the
+// puzzle's, the increments and comparison values range from -1,000 to 1,000.
+std::string GenerateInstructions(std::size_t count) {
+  constexpr const char* kOps[] = {"<", "<=", "==", "!=", ">=", ">"};
+  std::mt19937 generator(2017);
+  std::vector<std::string> names;
+  for (char c = 'a'; c <= 'z'; ++c)
+    names.push_back(std::string(1 + (c - 'a') % 3, c));
+  const auto Value = [&generator]() {
+    return std::to_string(static_cast<int>(generator() % 2001) - 1000);
+  };
+  std::string instructions;
+  for (std::size_t i = 0; i < count; ++i) {
+    instructions += names[generator() % names.size()];
+    instructions += (generator() % 2) ? " inc " : " dec ";
+    instructions += Value() + " if " + names[generator() % names.size()] + ' ' +
+                    kOps[generator() % 6] + ' ' + Value() + '\n';
+  }
+  return instructions;
+}
 
-  // In part 1, print the largest value currently in the register file; in part
-  // 2, print the largest value written.
-  std::cout << "Max value: " << (kPart1 ? MaxValue(registers) : max_value)
+// Times Execute() on 1,000 instructions, the puzzle's size, times each scale,
+// starting with empty registers each run.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleInstructions = 1000;
+  for (std::size_t scale : suite->Scales(1000)) {
+    std::istringstream stream(
+        GenerateInstructions(kPuzzleInstructions * scale));
+    std::vector<std::vector<std::string>> instructions;
+    for (std::string line; std::getline(stream, line); )
+      instructions.push_back(Tokenize(line));
+
+    suite->Run("Execute()", scale, instructions.size(), "instructions",
+               [&instructions]() {
+      int max_value = 0;
+      std::unordered_map<std::string, int> registers;
+      for (const auto& tokens : instructions)
+        max_value = std::max(max_value, Execute(tokens, &registers));
+      return max_value;
+    });
+  }
+}
+
+}  // namespace day8
+
+#if !defined(ADVENT_DRIVER)
+int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
+  std::cout << "Enter instructions; terminate with ctrl-z alone on a line."
             << std::endl;
+  std::string input;
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    input.assign(std::istreambuf_iterator<char>(std::cin),
+                 std::istreambuf_iterator<char>());
+  }
+
+  const solver::Answers answers = day8::Solve(input, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Max value: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Max value: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(8);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
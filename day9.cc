@@ -1,13 +1,20 @@
 // Advent of Code 2017 day 9 solution
 // Peter Kasting, Dec. 8, 2017
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <random>
+#include <sstream>
 #include <string>
 #include <tuple>
 
-namespace {
+#include "benchmark.h"
+#include "instrumentation.h"
+#include "options.h"
+#include "solver.h"
 
-constexpr bool kPart1 = false;  // Use true for part 1, false for part 2.
+namespace {
 
 // Counts the score of the groups in the stream and the number of total garbage
 // characters.  We need the former for part 1 and the latter for part 2.
@@ -38,18 +45,98 @@ std::tuple<int, int> ComputeScores(const std::string& stream) {
 
 }  // namespace
 
+namespace day9 {
+
+solver::Answers Solve(const std::string& input, options::Part) {
+  std::string garbage_stream;
+  {
+    instrumentation::Phase phase(instrumentation::kParse);
+    // The stream is the first word of the input.
+    std::istringstream stream(input);
+    stream >> garbage_stream;
+  }
+
+  instrumentation::Phase phase(instrumentation::kSolve);
+  const auto scores = ComputeScores(garbage_stream);
+  return {std::to_string(std::get<0>(scores)),
+          std::to_string(std::get<1>(scores))};
+}
+
+// Returns a random stream of at least |length| characters.  As in the puzzle,
+// groups nest up to a dozen deep and garbage includes '!'-canceled characters.
+std::string GenerateStream(std::size_t length) {
+  constexpr char kGarbage[] = "abcdefgh{}<,'\"!";
+  std::mt19937 generator(2017);
+  std::string stream = "{";
+  int depth = 1;
+  bool empty = true;  // Whether the innermost open group has no items yet.
+  while (depth) {
+    const std::uint32_t choice = generator() % 8;
+    if ((stream.size() >= length) || ((choice < 2) && (depth > 1))) {
+      stream += '}';
+      --depth;
+      empty = false;
+      continue;
+    }
+    if (!empty)
+      stream += ',';
+    if ((choice < 5) && (depth < 12)) {
+      stream += '{';
+      ++depth;
+      empty = true;
+      continue;
+    }
+    stream += '<';
+    for (std::size_t chars = generator() % 16; chars; --chars) {
+      const char c = kGarbage[generator() % (sizeof(kGarbage) - 1)];
+      stream += c;
+      if (c == '!')
+        stream += kGarbage[generator() % (sizeof(kGarbage) - 1)];
+    }
+    stream += '>';
+    empty = false;
+  }
+  return stream;
+}
+
+// Times ComputeScores() on a stream of 20,000 characters, about the puzzle's
+// length, times each scale.
+void RunSuite(benchmark::Suite* suite) {
+  constexpr std::size_t kPuzzleLength = 20000;
+  for (std::size_t scale : suite->Scales(10000)) {
+    const std::string stream = GenerateStream(kPuzzleLength * scale);
+    suite->Run("ComputeScores()", scale, stream.size(), "characters",
+               [&stream]() { return ComputeScores(stream); });
+  }
+}
+
+}  // namespace day9
+
+#if !defined(ADVENT_DRIVER)
 int main(int argc, char* argv[]) {
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part))
+    return 1;
+  instrumentation::EnableIfRequested(argc, argv);
+
   std::cout << "Enter stream: ";
 
   std::string stream;
-  std::cin >> stream;
-
-  const auto scores = ComputeScores(stream);
+  {
+    instrumentation::Phase phase(instrumentation::kRead);
+    std::cin >> stream;
+  }
 
-  if (kPart1)
-    std::cout << "Score: " << std::get<0>(scores) << std::endl;
-  else
-    std::cout << "Garbage characters: " << std::get<1>(scores) << std::endl;
+  const solver::Answers answers = day9::Solve(stream, part);
+  {
+    instrumentation::Phase phase(instrumentation::kFormat);
+    if (options::WantsPart1(part))
+      std::cout << "Score: " << answers.part1 << std::endl;
+    if (options::WantsPart2(part))
+      std::cout << "Garbage characters: " << answers.part2 << std::endl;
+  }
+  instrumentation::Report(9);
 
   return 0;
-}
\ No newline at end of file
+}
+#endif  // !defined(ADVENT_DRIVER)
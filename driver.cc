@@ -0,0 +1,267 @@
+// Advent of Code 2017 batch driver
+//
+// Links every day's solver into one program, so that a batch of puzzle inputs
+// can be solved without starting a process per input.  Each line of the
+// manifest (the file named on the command line, or stdin) is a job of the form
+// "<day> <input file>"; blank lines and lines starting with '#' are skipped.
+// The jobs run on a pool of worker threads, and their answers are written to
+// stdout as JSON, one object per line, in manifest order, e.g.:
+//
+//   {"day": 9, "input": "day9.txt", "part1": "14204", "part2": "6622", ...}
+//
+// Each object also has the job's solve time in "ms".  A job whose input can't
+// be read, or whose solver throws, gets an "error" member instead of answers,
+// and makes the driver exit with status 1.
+//
+// Options:
+//   --threads=N  Run N jobs at once (default: one per hardware thread).
+//                Some days also parallelize internally, so for big inputs
+//                fewer workers may do better.
+//   --part=1|2   Only compute one part's answers (default: both).
+//   --benchmark  Run every day's benchmarks instead of any jobs.
+//
+// Build with all the days, e.g.:
+//
+//   g++ -std=c++17 -O2 -pthread -DADVENT_DRIVER driver.cc day*.cc -o advent
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark.h"
+#include "options.h"
+#include "solver.h"
+
+namespace {
+
+// The solvers, indexed by day - 1.
+constexpr solver::SolveFunction kSolvers[] = {
+  day1::Solve,  day2::Solve,  day3::Solve,  day4::Solve,  day5::Solve,
+  day6::Solve,  day7::Solve,  day8::Solve,  day9::Solve,  day10::Solve,
+  day11::Solve, day12::Solve, day13::Solve, day14::Solve, day15::Solve,
+  day16::Solve, day17::Solve,
+};
+constexpr std::size_t kDays = std::size(kSolvers);
+
+// The days that have benchmarks, and their benchmarks.
+constexpr std::pair<std::size_t, solver::BenchmarkFunction> kBenchmarks[] = {
+  {10, day10::RunBenchmarks}, {11, day11::RunBenchmarks},
+  {12, day12::RunBenchmarks}, {13, day13::RunBenchmarks},
+  {14, day14::RunBenchmarks}, {15, day15::RunBenchmarks},
+  {16, day16::RunBenchmarks}, {17, day17::RunBenchmarks},
+};
+
+// A job from the manifest, and once it's run, its results.
+struct Job {
+  std::size_t day = 0;
+  std::string path;
+
+  solver::Answers answers;
+  std::string error;  // Nonempty if the job failed.
+  double seconds = 0;
+};
+
+// Parses |manifest| into |*jobs|.  Returns false, after printing an error, if
+// any line isn't a valid job.
+bool ParseManifest(const std::string& manifest, std::vector<Job>* jobs) {
+  std::istringstream stream(manifest);
+  std::string line;
+  for (std::size_t line_number = 1; std::getline(stream, line);
+       ++line_number) {
+    if (!line.empty() && (line.back() == '\r'))
+      line.pop_back();
+    const std::size_t start = line.find_first_not_of(" \t");
+    if ((start == std::string::npos) || (line[start] == '#'))
+      continue;
+
+    // The path is everything after the day, so it may contain spaces.
+    std::istringstream fields(line);
+    Job job;
+    fields >> job.day >> std::ws;
+    std::getline(fields, job.path);
+    if (!job.day || (job.day > kDays) || job.path.empty()) {
+      std::cerr << "Manifest line " << line_number
+                << " should be \"<day> <input file>\", with a day from 1 to "
+                << kDays << ": " << line << std::endl;
+      return false;
+    }
+    jobs->push_back(std::move(job));
+  }
+  return true;
+}
+
+// Reads the file at |path| into |*contents|, converting "\r\n" line endings to
+// "\n", as reading stdin in text mode would on Windows; the solvers only split
+// lines at '\n'.  Returns false if the file can't be opened.
+bool ReadFile(const std::string& path, std::string* contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return false;
+  contents->assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < contents->size(); ++i) {
+    if (((*contents)[i] != '\r') || (i + 1 == contents->size()) ||
+        ((*contents)[i + 1] != '\n'))
+      (*contents)[kept++] = (*contents)[i];
+  }
+  contents->resize(kept);
+  return true;
+}
+
+// Runs |*jobs| to compute |part|, on |threads| threads (or one per hardware
+// thread if |threads| is 0), which claim jobs one at a time from a shared
+// counter.
+void RunJobs(std::vector<Job>* jobs, options::Part part, unsigned threads) {
+  std::atomic<std::size_t> next(0);
+  const auto Work = [jobs, part, &next]() {
+    for (std::size_t i; (i = next.fetch_add(1)) < jobs->size(); ) {
+      Job& job = (*jobs)[i];
+      std::string input;
+      if (!ReadFile(job.path, &input)) {
+        job.error = "Can't read input file";
+        continue;
+      }
+      const auto start = std::chrono::steady_clock::now();
+      try {
+        job.answers = kSolvers[job.day - 1](input, part);
+      } catch (const std::exception& e) {
+        job.error = e.what();
+      }
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      job.seconds = elapsed.count();
+    }
+  };
+
+  if (!threads)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  threads = static_cast<unsigned>(
+      std::max<std::size_t>(std::min<std::size_t>(threads, jobs->size()), 1));
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads; ++i)
+    workers.emplace_back(Work);
+  Work();
+  for (auto& worker : workers)
+    worker.join();
+}
+
+// Appends |str| to |*output| as a quoted JSON string.
+void AppendJsonString(std::string_view str, std::string* output) {
+  output->push_back('"');
+  for (char c : str) {
+    if ((c == '"') || (c == '\\')) {
+      output->push_back('\\');
+      output->push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escape[7];
+      std::snprintf(escape, sizeof(escape), "\\u%04x",
+                    static_cast<unsigned>(c));
+      output->append(escape);
+    } else {
+      output->push_back(c);
+    }
+  }
+  output->push_back('"');
+}
+
+// Returns |job|'s results as a one-line JSON object.  Only the answers to
+// |part| are included.
+std::string ToJson(const Job& job, options::Part part) {
+  std::string json = "{\"day\": " + std::to_string(job.day) + ", \"input\": ";
+  AppendJsonString(job.path, &json);
+  if (!job.error.empty()) {
+    json += ", \"error\": ";
+    AppendJsonString(job.error, &json);
+  } else {
+    if (options::WantsPart1(part)) {
+      json += ", \"part1\": ";
+      AppendJsonString(job.answers.part1, &json);
+    }
+    if (options::WantsPart2(part)) {
+      json += ", \"part2\": ";
+      AppendJsonString(job.answers.part2, &json);
+    }
+    json += ", \"ms\": " + std::to_string(job.seconds * 1000);
+  }
+  json += '}';
+  return json;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (benchmark::Requested(argc, argv)) {
+    for (const auto& [day, func] : kBenchmarks) {
+      std::cout << "Day " << day << ":" << std::endl;
+      func();
+    }
+    return 0;
+  }
+
+  options::Part part;
+  if (!options::ParsePart(argc, argv, &part, options::Part::kBoth))
+    return 1;
+  unsigned threads = 0;
+  const char* manifest_path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    constexpr std::string_view kThreadsFlag = "--threads=";
+    constexpr std::string_view kPartFlag = "--part=";
+    bool valid = true;
+    if (arg.substr(0, kThreadsFlag.size()) == kThreadsFlag) {
+      const char* const value = argv[i] + kThreadsFlag.size();
+      char* end;
+      const unsigned long number = std::strtoul(value, &end, 10);
+      valid = (end != value) && !*end && (*value != '-') && number &&
+              (number <= std::numeric_limits<unsigned>::max());
+      threads = static_cast<unsigned>(number);
+    } else if (arg.substr(0, 2) != "--") {
+      manifest_path = argv[i];
+    } else {
+      // ParsePart() has already checked --part.
+      valid = arg.substr(0, kPartFlag.size()) == kPartFlag;
+    }
+    if (!valid) {
+      std::cerr << "Usage: " << argv[0]
+                << " [--threads=N] [--part=1|2|both] [manifest]" << std::endl;
+      return 1;
+    }
+  }
+
+  std::string manifest;
+  if (!manifest_path) {
+    manifest.assign(std::istreambuf_iterator<char>(std::cin),
+                    std::istreambuf_iterator<char>());
+  } else if (!ReadFile(manifest_path, &manifest)) {
+    std::cerr << "Can't read manifest " << manifest_path << std::endl;
+    return 1;
+  }
+  std::vector<Job> jobs;
+  if (!ParseManifest(manifest, &jobs))
+    return 1;
+
+  RunJobs(&jobs, part, threads);
+
+  bool failed = false;
+  for (const Job& job : jobs) {
+    std::cout << ToJson(job, part) << '\n';
+    failed |= !job.error.empty();
+  }
+  std::cout.flush();
+  return failed ? 1 : 0;
+}
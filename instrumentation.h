@@ -0,0 +1,183 @@
+// Advent of Code 2017 phase instrumentation
+//
+// Each day's main() and Solve() mark the phases of their work -- reading the
+// input, parsing it, solving, and formatting the answers -- with scoped Phase
+// objects.  Running a day with "--profile" on the command line times each
+// phase and, through Linux's perf_event_open(), counts its CPU cycles,
+// instructions, cache misses and branch misses, then writes a JSON report to
+// stderr, e.g.:
+//
+//   {"day": 5, "phases": [
+//     {"phase": "read", "calls": 1, "ms": 0.0412, "cycles": 98001, ...},
+//     ...
+//   ]}
+//
+// Counters that can't be opened (e.g. off Linux, in VMs without a PMU, or when
+// perf_event_paranoid forbids it) are reported as null.  Counters include any
+// threads a phase starts, as long as they finish within it.
+//
+// Without "--profile", a Phase costs a single well-predicted branch.  With it,
+// each Phase reads the counters when it starts and ends, so phases marked once
+// per input line add noticeably to their own totals.  Phases shouldn't nest, or
+// the inner phase's work would be counted twice.  The totals aren't
+// synchronized, so only the days' own main()s enable collection; the driver,
+// which solves on several threads at once, never does.
+
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace instrumentation {
+
+// The phases of a day's work.
+enum PhaseId { kRead, kParse, kSolve, kFormat };
+constexpr std::size_t kPhases = 4;
+constexpr const char* kPhaseNames[kPhases] = {"read", "parse", "solve",
+                                              "format"};
+
+// The hardware counters collected for each phase.
+constexpr std::size_t kCounters = 4;
+constexpr const char* kCounterNames[kCounters] = {
+  "cycles", "instructions", "cache_misses", "branch_misses",
+};
+
+// The running totals for one phase.
+struct PhaseTotals {
+  std::uint64_t calls = 0;
+  double seconds = 0;
+  std::uint64_t counts[kCounters] = {};
+};
+
+// The state shared by all Phases.  |counter_fds| holds -1 for each counter
+// that couldn't be opened.
+struct State {
+  bool enabled = false;
+  int counter_fds[kCounters] = {-1, -1, -1, -1};
+  PhaseTotals totals[kPhases];
+};
+inline State state;
+
+// Reads the current value of each open counter into |counts|.  Counters that
+// aren't open read as 0.
+inline void ReadCounters(std::uint64_t* counts) {
+  for (std::size_t i = 0; i < kCounters; ++i) {
+    counts[i] = 0;
+#if defined(__linux__)
+    if ((state.counter_fds[i] >= 0) &&
+        (read(state.counter_fds[i], &counts[i], sizeof(counts[i])) !=
+         static_cast<ssize_t>(sizeof(counts[i]))))
+      counts[i] = 0;
+#endif
+  }
+}
+
+// Turns on collection, opening whichever counters are available.  Counting
+// starts immediately and runs until the process exits; phases record the
+// differences across their lifetimes.
+inline void Enable() {
+  state.enabled = true;
+#if defined(__linux__)
+  constexpr std::uint64_t kConfigs[kCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES,
+  };
+  for (std::size_t i = 0; i < kCounters; ++i) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = kConfigs[i];
+    attr.inherit = 1;  // Count threads started by this one.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    state.counter_fds[i] = static_cast<int>(syscall(
+        SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+  }
+#endif
+}
+
+// Calls Enable() if "--profile" appears among the command-line arguments.
+inline void EnableIfRequested(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--profile")) {
+      Enable();
+      return;
+    }
+  }
+}
+
+// Marks its own lifetime as part of a phase, adding its wall time and counter
+// deltas to the phase's totals.
+class Phase {
+ public:
+  explicit Phase(PhaseId id) : id_(id), active_(state.enabled) {
+    if (!active_)
+      return;
+    ReadCounters(start_counts_);
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  Phase(const Phase&) = delete;
+  Phase& operator=(const Phase&) = delete;
+
+  ~Phase() {
+    if (!active_)
+      return;
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_;
+    std::uint64_t counts[kCounters];
+    ReadCounters(counts);
+    PhaseTotals& totals = state.totals[id_];
+    ++totals.calls;
+    totals.seconds += elapsed.count();
+    for (std::size_t i = 0; i < kCounters; ++i)
+      totals.counts[i] += counts[i] - start_counts_[i];
+  }
+
+ private:
+  const PhaseId id_;
+  const bool active_;
+  std::chrono::steady_clock::time_point start_;
+  std::uint64_t start_counts_[kCounters];
+};
+
+// If collection is enabled, writes the phase totals for |day| to stderr as
+// JSON.
+inline void Report(int day) {
+  if (!state.enabled)
+    return;
+  std::string json = "{\"day\": " + std::to_string(day) + ", \"phases\": [";
+  for (std::size_t phase = 0; phase < kPhases; ++phase) {
+    const PhaseTotals& totals = state.totals[phase];
+    char ms[32];
+    std::snprintf(ms, sizeof(ms), "%.4f", totals.seconds * 1000);
+    json += std::string(phase ? ",\n  " : "\n  ") + "{\"phase\": \"" +
+            kPhaseNames[phase] + "\", \"calls\": " +
+            std::to_string(totals.calls) + ", \"ms\": " + ms;
+    for (std::size_t i = 0; i < kCounters; ++i) {
+      json += std::string(", \"") + kCounterNames[i] + "\": " +
+              ((state.counter_fds[i] >= 0) ? std::to_string(totals.counts[i])
+                                           : std::string("null"));
+    }
+    json += '}';
+  }
+  json += "\n]}";
+  std::cerr << json << std::endl;
+}
+
+}  // namespace instrumentation
+
+#endif  // INSTRUMENTATION_H_
@@ -0,0 +1,57 @@
+// Advent of Code 2017 number-parsing helpers
+//
+// Several days' inputs are lines of numbers separated by punctuation, e.g.
+// "2 <-> 0, 3, 4".  Matching these with std::regex allocates a string per
+// number and is slow enough to dominate runs on large inputs, so these helpers
+// extract the numbers in place instead.
+
+#ifndef NUMBERS_H_
+#define NUMBERS_H_
+
+#include <cstddef>
+#include <string_view>
+
+namespace numbers {
+
+// Skips any non-digit characters at the start of |*input|, then parses the run
+// of digits after them into |*number|, removing everything through the last
+// digit from |*input|.  Returns false, leaving |*number| unchanged, if |*input|
+// contains no more digits.  Like std::regex("\\d+"), this ignores signs.
+template<typename T>
+bool NextNumber(std::string_view* input, T* number) {
+  std::size_t pos = 0;
+  const std::size_t size = input->size();
+  while ((pos < size) &&
+         (static_cast<unsigned char>((*input)[pos] - '0') > 9))
+    ++pos;
+  if (pos == size) {
+    input->remove_prefix(size);
+    return false;
+  }
+
+  T value = 0;
+  for (unsigned char digit;
+       (pos < size) && ((digit = static_cast<unsigned char>(
+                             (*input)[pos] - '0')) <= 9);
+       ++pos)
+    value = value * 10 + digit;
+  input->remove_prefix(pos);
+  *number = value;
+  return true;
+}
+
+// Removes the first line from |*input| and stores it, without the '\n', in
+// |*line|.  Returns false if |*input| is empty.
+inline bool NextLine(std::string_view* input, std::string_view* line) {
+  if (input->empty())
+    return false;
+  const std::size_t newline = input->find('\n');
+  *line = input->substr(0, newline);
+  input->remove_prefix(
+      (newline == std::string_view::npos) ? input->size() : (newline + 1));
+  return true;
+}
+
+}  // namespace numbers
+
+#endif  // NUMBERS_H_
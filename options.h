@@ -0,0 +1,58 @@
+// Advent of Code 2017 command-line options
+//
+// Each day's solution answers part 2 by default.  Running it with "--part=1"
+// answers part 1 instead, and "--part=both" answers both parts, part 1 first,
+// from a single run that reads and parses the input only once.
+
+#ifndef OPTIONS_H_
+#define OPTIONS_H_
+
+#include <iostream>
+#include <string_view>
+
+namespace options {
+
+// Which part(s) of the puzzle to answer.
+enum class Part { kPart1, kPart2, kBoth };
+
+// Sets |*part| from a "--part=1", "--part=2" or "--part=both" command-line
+// argument, defaulting to |default_part| if there is none.  Returns false,
+// after printing an error, if the argument has some other value.
+inline bool ParsePart(int argc,
+                      char* argv[],
+                      Part* part,
+                      Part default_part = Part::kPart2) {
+  *part = default_part;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg(argv[i]);
+    constexpr std::string_view kPartFlag = "--part=";
+    if (arg.substr(0, kPartFlag.size()) != kPartFlag)
+      continue;
+    const std::string_view value = arg.substr(kPartFlag.size());
+    if (value == "1") {
+      *part = Part::kPart1;
+    } else if (value == "2") {
+      *part = Part::kPart2;
+    } else if (value == "both") {
+      *part = Part::kBoth;
+    } else {
+      std::cout << "Part must be 1, 2 or both." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether |part| includes part 1.
+inline bool WantsPart1(Part part) {
+  return part != Part::kPart2;
+}
+
+// Returns whether |part| includes part 2.
+inline bool WantsPart2(Part part) {
+  return part != Part::kPart1;
+}
+
+}  // namespace options
+
+#endif  // OPTIONS_H_
@@ -0,0 +1,119 @@
+// Advent of Code 2017 solver interface
+//
+// Each day's solution exposes dayN::Solve(), which computes its answers from
+// the day's whole puzzle input, as read from stdin.  Each day's main() is a
+// thin wrapper around it, and driver.cc links every day into one program that
+// calls the solvers directly; compiling with ADVENT_DRIVER defined leaves out
+// the days' main()s.  bench.cc links them the same way to run each day's
+// benchmark suite, dayN::RunSuite().
+
+#ifndef SOLVER_H_
+#define SOLVER_H_
+
+#include <string>
+
+#include "options.h"
+
+namespace benchmark {
+class Suite;
+}
+
+namespace solver {
+
+// A day's answers, as they'd be printed.  Answers to parts that weren't asked
+// for may be left empty.
+struct Answers {
+  std::string part1, part2;
+};
+
+// Computes a day's answers to |part| from its puzzle |input|.
+using SolveFunction = Answers (*)(const std::string& input, options::Part part);
+
+// Runs a day's benchmarks, as with "--benchmark".
+using BenchmarkFunction = void (*)();
+
+// Runs a day's benchmark suite, recording the results in |suite|.
+using SuiteFunction = void (*)(benchmark::Suite* suite);
+
+}  // namespace solver
+
+// The days' solvers and benchmark suites.  Days with "--benchmark" benchmarks
+// also expose them.
+namespace day1 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day2 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day3 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day4 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day5 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day6 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day7 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day8 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day9 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+}
+namespace day10 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day11 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day12 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day13 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day14 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day15 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day16 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+namespace day17 {
+solver::Answers Solve(const std::string& input, options::Part part);
+void RunSuite(benchmark::Suite* suite);
+void RunBenchmarks();
+}
+
+#endif  // SOLVER_H_